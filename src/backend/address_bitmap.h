@@ -0,0 +1,70 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef ADDRESS_BITMAP_H
+#define ADDRESS_BITMAP_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace lc3
+{
+namespace core
+{
+    // One bit for every address in the 64K address space, so membership can be checked in constant time before every
+    // instruction or memory access.
+    class AddressBitmap
+    {
+    public:
+        AddressBitmap(void) : count(0) { bits.fill(0); }
+
+        bool test(uint16_t addr) const { return (bits[addr >> 6] & (1ull << (addr & 0x3F))) != 0; }
+        bool empty(void) const { return count == 0; }
+        uint32_t size(void) const { return count; }
+
+        void set(uint16_t addr)
+        {
+            if(! test(addr)) {
+                bits[addr >> 6] |= 1ull << (addr & 0x3F);
+                count += 1;
+            }
+        }
+
+        void reset(uint16_t addr)
+        {
+            if(test(addr)) {
+                bits[addr >> 6] &= ~(1ull << (addr & 0x3F));
+                count -= 1;
+            }
+        }
+
+        void clear(void)
+        {
+            bits.fill(0);
+            count = 0;
+        }
+
+        // Returns every address that is set, in ascending order.
+        std::vector<uint16_t> list(void) const
+        {
+            std::vector<uint16_t> ret;
+            ret.reserve(count);
+            for(uint32_t word = 0; word < bits.size() && ret.size() < count; word += 1) {
+                for(uint64_t remaining = bits[word]; remaining != 0; remaining &= remaining - 1) {
+                    uint32_t bit = 0;
+                    while(((remaining >> bit) & 1) == 0) { bit += 1; }
+                    ret.push_back(static_cast<uint16_t>((word << 6) + bit));
+                }
+            }
+            return ret;
+        }
+
+    private:
+        std::array<uint64_t, (1 << 16) / 64> bits;
+        uint32_t count;
+    };
+};
+};
+
+#endif
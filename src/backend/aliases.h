@@ -8,6 +8,8 @@
 #include <memory>
 #include <string>
 
+#include "pool.h"
+
 namespace lc3
 {
 namespace core
@@ -18,10 +20,10 @@ namespace core
     class IMicroOp;
     class IDevice;
 
-    using PIOperand = std::shared_ptr<IOperand>;
-    using PIInstruction = std::shared_ptr<IInstruction>;
-    using PIEvent = std::shared_ptr<IEvent>;
-    using PIMicroOp = std::shared_ptr<IMicroOp>;
+    using PIOperand = std::shared_ptr<IOperand const>;
+    using PIInstruction = std::shared_ptr<IInstruction const>;
+    using PIEvent = IntrusivePtr<IEvent>;
+    using PIMicroOp = IntrusivePtr<IMicroOp>;
     using PIDevice = std::shared_ptr<IDevice>;
 
     using SymbolTable = std::map<std::string, uint32_t>;
@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <vector>
@@ -26,21 +27,39 @@ lc3::core::Assembler::assemble(std::istream & buffer)
     bool success = true;
     uint32_t fail_pass = 0;
 
+    timings = AssemblerTimings();
+    auto phase_start = std::chrono::steady_clock::now();
+    auto lap = [&phase_start](void) {
+        auto now = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(now - phase_start).count();
+        phase_start = now;
+        return seconds;
+    };
+
     logger.printf(PrintType::P_EXTRA, true, "===== begin identifying tokens =====");
-    std::vector<Statement> statements = buildStatements(buffer);
+    std::vector<std::vector<Token>> lines = tokenize(buffer);
     logger.printf(PrintType::P_EXTRA, true, "===== end identifying tokens =====");
     logger.newline(PrintType::P_EXTRA);
+    timings.tokenize = lap();
+
+    logger.printf(PrintType::P_EXTRA, true, "===== begin building statements =====");
+    std::vector<Statement> statements = buildStatements(lines);
+    logger.printf(PrintType::P_EXTRA, true, "===== end building statements =====");
+    logger.newline(PrintType::P_EXTRA);
+    timings.build_statements = lap();
 
     logger.printf(PrintType::P_EXTRA, true, "===== begin marking PCs =====");
     setStatementPCField(statements);
     logger.printf(PrintType::P_EXTRA, true, "===== end marking PCs =====");
     logger.newline(PrintType::P_EXTRA);
+    timings.mark_pcs = lap();
 
     logger.printf(PrintType::P_EXTRA, true, "===== begin building symbol table =====");
     std::pair<bool, SymbolTable> symbols = buildSymbolTable(statements);
     success &= symbols.first;
     logger.printf(PrintType::P_EXTRA, true, "===== end building symbol table =====");
     logger.newline(PrintType::P_EXTRA);
+    timings.symbol_table = lap();
     if(! success) {
         logger.printf(PrintType::P_ERROR, true, "pass 1 failed, attempting to continue to pass 2");
         logger.newline();
@@ -52,6 +71,7 @@ lc3::core::Assembler::assemble(std::istream & buffer)
     success &= machine_code_blob.first;
     logger.printf(PrintType::P_EXTRA, true, "===== end assembling =====");
     logger.newline(PrintType::P_EXTRA);
+    timings.encode = lap();
     if(! success && fail_pass == 0) {
         fail_pass = 2;
     }
@@ -71,16 +91,17 @@ lc3::core::Assembler::assemble(std::istream & buffer)
     for(MemLocation const & entry : machine_code_blob.second) {
         (*ret) << entry;
     }
+    timings.serialize = lap();
     return std::make_pair(ret, symbols.second);
 }
 
-std::vector<lc3::core::asmbl::Statement> lc3::core::Assembler::buildStatements(std::istream & buffer)
+std::vector<std::vector<lc3::core::asmbl::Token>> lc3::core::Assembler::tokenize(std::istream & buffer)
 {
     using namespace asmbl;
     using namespace lc3::utils;
 
     Tokenizer tokenizer{buffer, enable_liberal_asm};
-    std::vector<Statement> statements;
+    std::vector<std::vector<Token>> lines;
 
     while(! tokenizer.isDone()) {
         std::vector<Token> tokens;
@@ -95,10 +116,24 @@ std::vector<lc3::core::asmbl::Statement> lc3::core::Assembler::buildStatements(s
         }
 
         if(! tokenizer.isDone()) {
-            statements.push_back(buildStatement(tokens));
+            lines.push_back(std::move(tokens));
         }
     }
 
+    return lines;
+}
+
+std::vector<lc3::core::asmbl::Statement> lc3::core::Assembler::buildStatements(
+    std::vector<std::vector<lc3::core::asmbl::Token>> const & lines)
+{
+    using namespace asmbl;
+
+    std::vector<Statement> statements;
+    statements.reserve(lines.size());
+    for(std::vector<Token> const & tokens : lines) {
+        statements.push_back(buildStatement(tokens));
+    }
+
     return statements;
 }
 
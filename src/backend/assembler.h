@@ -18,6 +18,18 @@ namespace lc3
 {
 namespace core
 {
+    // Wall time, in seconds, spent in each phase of the most recent call to Assembler::assemble.  Phases that were
+    // not reached because assembly failed are 0.
+    struct AssemblerTimings
+    {
+        double tokenize = 0;
+        double build_statements = 0;
+        double mark_pcs = 0;
+        double symbol_table = 0;
+        double encode = 0;
+        double serialize = 0;
+    };
+
     class Assembler
     {
     public:
@@ -32,6 +44,7 @@ namespace core
         void setFilename(std::string const & filename) { logger.setFilename(filename); }
 
         void setLiberalAsm(bool enable_liberal_asm);
+        AssemblerTimings const & getTimings(void) const { return timings; }
 
     private:
         std::vector<std::string> file_buffer;
@@ -39,8 +52,10 @@ namespace core
         bool enable_liberal_asm;
 
         asmbl::Encoder encoder;
+        AssemblerTimings timings;
 
-        std::vector<asmbl::Statement> buildStatements(std::istream & buffer);
+        std::vector<std::vector<asmbl::Token>> tokenize(std::istream & buffer);
+        std::vector<asmbl::Statement> buildStatements(std::vector<std::vector<asmbl::Token>> const & lines);
         asmbl::Statement buildStatement(std::vector<asmbl::Token> const & tokens);
         void setStatementPCField(std::vector<asmbl::Statement> & statements);
         std::pair<bool, SymbolTable> buildSymbolTable(std::vector<asmbl::Statement> const & statements);
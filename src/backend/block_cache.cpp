@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "block_cache.h"
+#include "device_regs.h"
+
+using namespace lc3::core::sim;
+
+BlockCache::BlockCache(void) : pages(1 << 8)
+{
+    uncached.start_pc = 0;
+    uncached.length = 0;
+    uncached.generation = 0;
+    uncached.exec_count = 0;
+    uncached.native_epoch = 0;
+    uncached.native_code = nullptr;
+}
+
+BasicBlock & BlockCache::lookup(MachineState & state)
+{
+    uint16_t pc = state.readPC();
+
+    // Instructions fetched from device registers are never cached.
+    if(pc >= MMIO_START) {
+        return uncached;
+    }
+
+    std::unique_ptr<Page> & page = pages[pc >> 8];
+    if(page == nullptr) {
+        // Pages are allocated on first use; a typical program only executes from a handful of them.
+        page.reset(new Page());
+        for(BasicBlock & block : *page) {
+            block.length = 0;
+        }
+    }
+
+    BasicBlock & block = (*page)[pc & 0xFF];
+    if(block.length == 0 || ! isValid(block, state)) {
+        translate(block, state, pc);
+    }
+
+    return block;
+}
+
+void BlockCache::translate(BasicBlock & block, MachineState & state, uint16_t pc) const
+{
+    block.start_pc = pc;
+    block.length = 0;
+    block.generation = state.getPageGeneration(pc);
+    block.exec_count = 0;
+    block.native_epoch = 0;
+    block.native_code = nullptr;
+
+    uint32_t addr = pc;
+    do {
+        uint16_t word = state.readMem(static_cast<uint16_t>(addr)).first;
+        DecodedInstruction const & decoded = decoder.decode(word);
+
+        state.markTranslated(static_cast<uint16_t>(addr));
+        block.words[block.length] = word;
+        block.insts[block.length] = &decoded;
+        block.length += 1;
+        addr += 1;
+
+        if(decoded.inst == nullptr) { break; }
+
+        bool ends_block = false;
+        switch(decoded.type) {
+            case InstType::BR:
+            case InstType::JMP:
+            case InstType::JSR:
+            case InstType::JSRR:
+            case InstType::RTI:
+            case InstType::TRAP:
+                ends_block = true;
+                break;
+
+            default:
+                break;
+        }
+
+        if(ends_block) { break; }
+    } while(block.length < BasicBlock::MAX_LENGTH && (addr & 0xFF) != 0);
+}
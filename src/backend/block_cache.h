@@ -0,0 +1,63 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef BLOCK_CACHE_H
+#define BLOCK_CACHE_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "decoder.h"
+#include "state.h"
+
+namespace lc3
+{
+namespace core
+{
+namespace sim
+{
+    // A run of instructions that ends with the first control-flow instruction (BR, JMP, JSR, JSRR, TRAP, or RTI), an
+    // illegal instruction, or the end of a memory page.  Blocks never span pages, so a single page generation is
+    // enough to tell whether any of the instructions have been overwritten since the block was translated.
+    struct BasicBlock
+    {
+        static constexpr uint32_t MAX_LENGTH = 32;
+
+        uint16_t start_pc;
+        uint16_t length;
+        uint32_t generation;
+        uint16_t words[MAX_LENGTH];
+        DecodedInstruction const * insts[MAX_LENGTH];
+
+        // Used by the JIT, which compiles a block once it has been entered exec_count times.
+        uint32_t exec_count;
+        uint32_t native_epoch;
+        void const * native_code;
+    };
+
+    class BlockCache
+    {
+    public:
+        BlockCache(void);
+
+        BasicBlock & lookup(MachineState & state);
+        bool isValid(BasicBlock const & block, MachineState const & state) const {
+            return block.generation == state.getPageGeneration(block.start_pc);
+        }
+
+    private:
+        using Page = std::array<BasicBlock, 1 << 8>;
+
+        Decoder decoder;
+        std::vector<std::unique_ptr<Page>> pages;
+        BasicBlock uncached;
+
+        void translate(BasicBlock & block, MachineState & state, uint16_t pc) const;
+    };
+};
+};
+};
+
+#endif
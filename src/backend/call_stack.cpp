@@ -0,0 +1,51 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "call_stack.h"
+
+using namespace lc3::core;
+
+void CallStack::push(StackFrame const & frame)
+{
+    uint32_t slot = static_cast<uint32_t>(depth % CAPACITY);
+    if(slot == frames.size()) {
+        frames.push_back(frame);
+    } else {
+        frames[slot] = frame;
+    }
+
+    depth += 1;
+    if(valid < CAPACITY) {
+        valid += 1;
+    }
+}
+
+void CallStack::pop(void)
+{
+    // A return without a matching call, e.g. from code that was running before the stack was cleared, is ignored.
+    if(depth == 0) {
+        return;
+    }
+
+    depth -= 1;
+    if(valid > 0) {
+        valid -= 1;
+    }
+}
+
+void CallStack::clear(void)
+{
+    frames.clear();
+    depth = 0;
+    valid = 0;
+}
+
+std::vector<StackFrame> CallStack::getFrames(void) const
+{
+    std::vector<StackFrame> ret;
+    ret.reserve(valid);
+    for(uint32_t i = 0; i < valid; i += 1) {
+        ret.push_back(frames[(depth - 1 - i) % CAPACITY]);
+    }
+    return ret;
+}
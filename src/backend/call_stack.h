@@ -0,0 +1,52 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef CALL_STACK_H
+#define CALL_STACK_H
+
+#include <cstdint>
+#include <vector>
+
+#include "func_type.h"
+
+namespace lc3
+{
+namespace core
+{
+    struct StackFrame
+    {
+        // Address of the instruction that was executing when the routine was entered.  For an interrupt, this is the
+        // last instruction to complete before it.
+        uint16_t call_pc;
+        // Address of the first instruction of the routine.
+        uint16_t routine;
+        FuncType type;
+    };
+
+    // Shadow of the subroutines, traps, interrupts, and exceptions that have been entered but not yet returned from.
+    // Only the innermost CAPACITY frames are kept, so a program that recurses without end uses a bounded amount of
+    // memory.  The full depth is still tracked, so returns are matched with the right frames.
+    class CallStack
+    {
+    public:
+        static constexpr uint32_t CAPACITY = 1 << 12;
+
+        void push(StackFrame const & frame);
+        void pop(void);
+        void clear(void);
+
+        uint64_t getDepth(void) const { return depth; }
+        // Innermost frame first.  There are fewer frames than the depth if the outermost ones were dropped.
+        std::vector<StackFrame> getFrames(void) const;
+
+    private:
+        // Ring buffer indexed by depth, which only grows as deep as the program has gone.
+        std::vector<StackFrame> frames;
+        uint64_t depth = 0;
+        // Number of innermost frames that have not been overwritten.
+        uint32_t valid = 0;
+    };
+};
+};
+
+#endif
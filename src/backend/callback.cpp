@@ -17,6 +17,7 @@ std::string lc3::core::callbackTypeToString(CallbackType type)
         case CallbackType::BREAKPOINT: return "breakpoint";
         case CallbackType::INPUT_REQUEST: return "input-request";
         case CallbackType::INPUT_POLL: return "input-poll";
+        case CallbackType::WATCHPOINT: return "watchpoint";
         default: return "unknown";
     }
 }
@@ -21,6 +21,7 @@ namespace core
           BREAKPOINT = -3
         , PRE_INST = -2
         , INT_ENTER = -1
+        , WATCHPOINT = 0
         , EX_ENTER = 1
         , EX_EXIT = 2
         , INT_EXIT = 3
@@ -34,6 +35,21 @@ namespace core
 
     std::string callbackTypeToString(CallbackType type);
     CallbackTypeUnderlying callbackTypeToUnderlying(CallbackType type);
+
+    // Callback types are numbered densely starting from BREAKPOINT, so they can index arrays and bitmasks.
+    constexpr uint32_t NUM_CALLBACK_TYPES = static_cast<uint32_t>(
+        static_cast<CallbackTypeUnderlying>(CallbackType::INVALID) -
+        static_cast<CallbackTypeUnderlying>(CallbackType::BREAKPOINT));
+    inline uint32_t callbackTypeToIndex(CallbackType type)
+    {
+        return static_cast<uint32_t>(static_cast<CallbackTypeUnderlying>(type) -
+            static_cast<CallbackTypeUnderlying>(CallbackType::BREAKPOINT));
+    }
+    inline CallbackType callbackIndexToType(uint32_t index)
+    {
+        return static_cast<CallbackType>(static_cast<CallbackTypeUnderlying>(index) +
+            static_cast<CallbackTypeUnderlying>(CallbackType::BREAKPOINT));
+    }
 };
 };
 
@@ -1,31 +1,64 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include <vector>
+
 #include "decoder.h"
 
 using namespace lc3::core::sim;
 
-Decoder::Decoder(void) : ISAHandler()
+namespace
 {
-    for(PIInstruction inst : instructions) {
+    class PredecodedTable
+    {
+    public:
+        PredecodedTable(void);
+
+        std::vector<DecodedInstruction> entries;
+
+    private:
+        std::map<uint16_t, std::vector<lc3::core::PIInstruction>> instructions_by_opcode;
+
+        lc3::core::IInstruction const * match(uint16_t value) const;
+        static InstType getType(uint16_t value);
+        static uint16_t getImmediate(InstType type, uint16_t value);
+    };
+};
+
+PredecodedTable::PredecodedTable(void) : entries(1 << 16)
+{
+    using namespace lc3::utils;
+
+    for(lc3::core::PIInstruction inst : lc3::core::ISAHandler::get().getInstructions()) {
         uint16_t opcode = inst->getOperand(0)->getValue();
         instructions_by_opcode[opcode].push_back(inst);
     }
+
+    for(uint32_t value = 0; value < entries.size(); value += 1) {
+        DecodedInstruction & entry = entries[value];
+        entry.inst = match(value);
+        entry.type = entry.inst != nullptr ? getType(value) : InstType::INVALID;
+        entry.imm = getImmediate(entry.type, value);
+        entry.dr = getBits(value, 11, 9);
+        entry.sr1 = getBits(value, 8, 6);
+        entry.sr2 = getBits(value, 2, 0);
+        entry.cc = getBits(value, 11, 9);
+        entry.vec = getBits(value, 7, 0);
+    }
 }
 
-lc3::optional<lc3::core::PIInstruction> Decoder::decode(uint16_t value) const
+lc3::core::IInstruction const * PredecodedTable::match(uint16_t value) const
 {
     auto search = instructions_by_opcode.find(lc3::utils::getBits(value, 15, 12));
-    bool valid = false;
 
     if(search != instructions_by_opcode.end()) {
         // Search instructions with the same opcode for a match.
-        for(PIInstruction inst : search->second) {
+        for(lc3::core::PIInstruction inst : search->second) {
             uint32_t bit_check_pos = 15;
-            valid = true;
+            bool valid = true;
             // Scan over all fixed operands in instruction to determine if there's a match.
-            for(PIOperand const op : inst->getOperands()) {
-                if(op->getType() == IOperand::Type::FIXED) {
+            for(lc3::core::PIOperand const op : inst->getOperands()) {
+                if(op->getType() == lc3::core::IOperand::Type::FIXED) {
                     if(lc3::utils::getBits(value, bit_check_pos, bit_check_pos - op->getWidth() + 1) !=
                         op->getValue())
                     {
@@ -37,17 +70,69 @@ lc3::optional<lc3::core::PIInstruction> Decoder::decode(uint16_t value) const
             }
 
             if(valid) {
-                uint32_t bit_pos = 15;
-                for(PIOperand op : inst->getOperands()) {
-                    if(op->getType() != IOperand::Type::FIXED) {
-                        op->setValue(lc3::utils::getBits(value, bit_pos, bit_pos - op->getWidth() + 1));
-                    }
-                    bit_pos -= op->getWidth();
-                }
-                return inst;
+                return inst.get();
             }
         }
     }
 
-    return {};
+    return nullptr;
+}
+
+InstType PredecodedTable::getType(uint16_t value)
+{
+    using namespace lc3::utils;
+
+    switch(getBits(value, 15, 12)) {
+        case 0x0: return InstType::BR;
+        case 0x1: return getBit(value, 5) == 1 ? InstType::ADD_IMM : InstType::ADD_REG;
+        case 0x2: return InstType::LD;
+        case 0x3: return InstType::ST;
+        case 0x4: return getBit(value, 11) == 1 ? InstType::JSR : InstType::JSRR;
+        case 0x5: return getBit(value, 5) == 1 ? InstType::AND_IMM : InstType::AND_REG;
+        case 0x6: return InstType::LDR;
+        case 0x7: return InstType::STR;
+        case 0x8: return InstType::RTI;
+        case 0x9: return InstType::NOT;
+        case 0xa: return InstType::LDI;
+        case 0xb: return InstType::STI;
+        case 0xc: return InstType::JMP;
+        case 0xe: return InstType::LEA;
+        case 0xf: return InstType::TRAP;
+        default: return InstType::INVALID;
+    }
+}
+
+uint16_t PredecodedTable::getImmediate(InstType type, uint16_t value)
+{
+    using namespace lc3::utils;
+
+    switch(type) {
+        case InstType::ADD_IMM:
+        case InstType::AND_IMM:
+            return sextTo16(getBits(value, 4, 0), 5);
+
+        case InstType::LDR:
+        case InstType::STR:
+            return sextTo16(getBits(value, 5, 0), 6);
+
+        case InstType::BR:
+        case InstType::LD:
+        case InstType::LDI:
+        case InstType::LEA:
+        case InstType::ST:
+        case InstType::STI:
+            return sextTo16(getBits(value, 8, 0), 9);
+
+        case InstType::JSR:
+            return sextTo16(getBits(value, 10, 0), 11);
+
+        default:
+            return 0;
+    }
+}
+
+Decoder::Decoder(void)
+{
+    static PredecodedTable const predecoded;
+    table = predecoded.entries.data();
 }
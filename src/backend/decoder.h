@@ -4,6 +4,8 @@
 #ifndef DECODER_H
 #define DECODER_H
 
+#include <cstdint>
+
 #include "isa_abstract.h"
 #include "utils.h"
 
@@ -13,15 +15,53 @@ namespace core
 {
 namespace sim
 {
-    class Decoder : public lc3::core::ISAHandler
+    enum class InstType : uint8_t
+    {
+          ADD_REG
+        , ADD_IMM
+        , AND_REG
+        , AND_IMM
+        , BR
+        , JMP
+        , JSR
+        , JSRR
+        , LD
+        , LDI
+        , LDR
+        , LEA
+        , NOT
+        , RTI
+        , ST
+        , STI
+        , STR
+        , TRAP
+        , INVALID
+    };
+
+    // Decoded form of a single 16-bit word.  The fields are extracted from the word regardless of type, so only the
+    // ones used by the instruction are meaningful: dr holds bits [11:9] (the source register for stores), sr1 holds
+    // bits [8:6] (the base register for LDR, STR, JMP, and JSRR), and sr2 holds bits [2:0].  imm is the sign-extended
+    // immediate or PC offset.  inst is nullptr if the word is not a legal instruction.
+    struct DecodedInstruction
+    {
+        IInstruction const * inst;
+        uint16_t imm;
+        InstType type;
+        uint8_t dr, sr1, sr2;
+        uint8_t cc, vec;
+    };
+
+    // Every possible word is decoded once per process into an immutable table, so decoding is a single lookup and
+    // decoders may be shared freely between simulators and threads.
+    class Decoder
     {
     public:
         Decoder(void);
 
-        optional<PIInstruction> decode(uint16_t value) const;
+        DecodedInstruction const & decode(uint16_t value) const { return table[value]; }
 
     private:
-        std::map<uint16_t, std::vector<PIInstruction>> instructions_by_opcode;
+        DecodedInstruction const * table;
     };
 };
 };
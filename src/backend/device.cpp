@@ -1,33 +1,12 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include <limits>
+
 #include "device.h"
 
 using namespace lc3::core;
 
-std::pair<uint16_t, PIMicroOp> RWReg::read(uint16_t addr)
-{
-    if(addr == data_addr) {
-        return std::make_pair(data.getValue(), nullptr);
-    }
-
-    return std::make_pair(0x0000, nullptr);
-}
-
-PIMicroOp RWReg::write(uint16_t addr, uint16_t value)
-{
-    if(addr == data_addr) {
-        data.setValue(value);
-    }
-
-    return nullptr;
-}
-
-std::vector<uint16_t> RWReg::getAddrMap(void) const
-{
-    return { data_addr };
-}
-
 KeyboardDevice::KeyboardDevice(lc3::utils::IInputter & inputter) : inputter(inputter)
 {
     status.setValue(0x0000);
@@ -47,14 +26,14 @@ void KeyboardDevice::shutdown(void)
 std::pair<uint16_t, PIMicroOp> KeyboardDevice::read(uint16_t addr)
 {
     if(addr == KBSR) {
-        PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::INPUT_POLL);
+        PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::INPUT_POLL);
         return std::make_pair(status.getValue(), callback);
     } else if(addr == KBDR) {
         uint16_t status_value = status.getValue();
         if(utils::getBit(status_value, 15) == 1) {
-            PIMicroOp write_addr = std::make_shared<RegWriteImmMicroOp>(8, KBSR);
-            PIMicroOp toggle_status = std::make_shared<MemWriteImmMicroOp>(8, status_value & 0x7FFF);
-            PIMicroOp pop_from_buffer = std::make_shared<GenericPopMicroOp<std::queue<KeyInfo>>>(key_buffer, "kbbuf");
+            PIMicroOp write_addr = makePooled<RegWriteImmMicroOp>(8, KBSR);
+            PIMicroOp toggle_status = makePooled<MemWriteImmMicroOp>(8, status_value & 0x7FFF);
+            PIMicroOp pop_from_buffer = makePooled<GenericPopMicroOp<std::queue<KeyInfo>>>(key_buffer, "kbbuf");
             write_addr->insert(toggle_status);
             toggle_status->insert(pop_from_buffer);
             return std::make_pair(data.getValue(), write_addr);
@@ -62,7 +41,7 @@ std::pair<uint16_t, PIMicroOp> KeyboardDevice::read(uint16_t addr)
             PIMicroOp callback = nullptr;
 
             if(! inputter.hasRemaining()) {
-                callback = std::make_shared<CallbackMicroOp>(CallbackType::INPUT_REQUEST);
+                callback = makePooled<CallbackMicroOp>(CallbackType::INPUT_REQUEST);
             }
 
             return std::make_pair(data.getValue(), callback);
@@ -100,13 +79,53 @@ PIMicroOp KeyboardDevice::tick(void)
 
         if(! key_buffer.front().triggered_interrupt && (status.getValue() & 0x4000) == 0x4000) {
             key_buffer.front().triggered_interrupt = true;
-            return std::make_shared<PushInterruptTypeMicroOp>(InterruptType::KEYBOARD);
+            return makePooled<PushInterruptTypeMicroOp>(InterruptType::KEYBOARD);
         }
     }
 
     return nullptr;
 }
 
+uint64_t KeyboardDevice::getIdleTicks(void) const
+{
+    // Buffered keys are written to the registers (and may raise an interrupt) on every tick, so only an empty buffer
+    // leaves the ticks up to the inputter.
+    if(! key_buffer.empty()) {
+        return 0;
+    }
+
+    return inputter.getIdleCalls();
+}
+
+void KeyboardDevice::skipIdleTicks(uint64_t count) { inputter.skipIdleCalls(count); }
+
+std::vector<uint16_t> KeyboardDevice::saveState(void) const
+{
+    // Buffered keys are stored after the registers as (value, triggered interrupt) pairs.
+    std::vector<uint16_t> ret = { status.getValue(), data.getValue() };
+    std::queue<KeyInfo> keys = key_buffer;
+    while(! keys.empty()) {
+        ret.push_back(static_cast<uint16_t>(static_cast<unsigned char>(keys.front().value)));
+        ret.push_back(keys.front().triggered_interrupt ? 1 : 0);
+        keys.pop();
+    }
+    return ret;
+}
+
+void KeyboardDevice::restoreState(std::vector<uint16_t> const & state)
+{
+    if(state.size() < 2) { return; }
+
+    status.setValue(state[0]);
+    data.setValue(state[1]);
+    key_buffer = std::queue<KeyInfo>();
+    for(size_t i = 2; i + 1 < state.size(); i += 2) {
+        KeyInfo key(static_cast<char>(state[i]));
+        key.triggered_interrupt = state[i + 1] != 0;
+        key_buffer.push(key);
+    }
+}
+
 std::pair<uint16_t, PIMicroOp> DisplayDevice::read(uint16_t addr)
 {
     if(addr == DSR) {
@@ -155,3 +174,26 @@ PIMicroOp DisplayDevice::tick(void)
 
     return nullptr;
 }
+
+uint64_t DisplayDevice::getIdleTicks(void) const
+{
+    // Once the ready bit is set, ticks do nothing until the program writes to the display.
+    if((status.getValue() & 0x8000) == 0) {
+        return 0;
+    }
+
+    return std::numeric_limits<uint64_t>::max();
+}
+
+std::vector<uint16_t> DisplayDevice::saveState(void) const
+{
+    return { status.getValue(), data.getValue() };
+}
+
+void DisplayDevice::restoreState(std::vector<uint16_t> const & state)
+{
+    if(state.size() < 2) { return; }
+
+    status.setValue(state[0]);
+    data.setValue(state[1]);
+}
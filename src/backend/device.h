@@ -32,22 +32,15 @@ namespace core
         virtual std::vector<uint16_t> getAddrMap(void) const = 0;
         virtual std::string getName(void) const = 0;
         virtual PIMicroOp tick(void) { return nullptr; }
-    };
-
-    class RWReg : public IDevice
-    {
-    public:
-        RWReg(uint16_t data_addr) : data_addr(data_addr) { data.setValue(0x0000); }
-        virtual ~RWReg(void) override = default;
-
-        virtual std::pair<uint16_t, PIMicroOp> read(uint16_t addr) override;
-        virtual PIMicroOp write(uint16_t addr, uint16_t value) override;
-        virtual std::vector<uint16_t> getAddrMap(void) const override;
-        virtual std::string getName(void) const override { return "RWReg"; }
-
-    private:
-        MemLocation data;
-        uint16_t data_addr;
+        // The number of upcoming ticks that are known to leave the device registers unchanged and to return no
+        // micro-ops, as long as the registers are not accessed in the meantime.  The simulator may skip that many
+        // ticks and report how many it skipped with skipIdleTicks.
+        virtual uint64_t getIdleTicks(void) const { return 0; }
+        virtual void skipIdleTicks(uint64_t count) { (void) count; }
+
+        // Device registers and any buffered state, flattened into words so that it can be captured by snapshots.
+        virtual std::vector<uint16_t> saveState(void) const { return {}; }
+        virtual void restoreState(std::vector<uint16_t> const & state) { (void) state; }
     };
 
     class KeyboardDevice : public IDevice
@@ -63,6 +56,10 @@ namespace core
         virtual std::vector<uint16_t> getAddrMap(void) const override;
         virtual std::string getName(void) const override { return "Keyboard"; }
         virtual PIMicroOp tick(void) override;
+        virtual uint64_t getIdleTicks(void) const override;
+        virtual void skipIdleTicks(uint64_t count) override;
+        virtual std::vector<uint16_t> saveState(void) const override;
+        virtual void restoreState(std::vector<uint16_t> const & state) override;
 
     private:
         lc3::utils::IInputter & inputter;
@@ -93,6 +90,9 @@ namespace core
         virtual std::vector<uint16_t> getAddrMap(void) const override;
         virtual std::string getName(void) const override { return "Display"; }
         virtual PIMicroOp tick(void) override;
+        virtual uint64_t getIdleTicks(void) const override;
+        virtual std::vector<uint16_t> saveState(void) const override;
+        virtual void restoreState(std::vector<uint16_t> const & state) override;
 
     private:
         lc3::utils::Logger & logger;
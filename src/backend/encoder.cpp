@@ -11,12 +11,8 @@
 using namespace lc3::core::asmbl;
 
 Encoder::Encoder(lc3::utils::AssemblerLogger & logger, bool enable_liberal_asm)
-    : ISAHandler(), logger(logger), enable_liberal_asm(enable_liberal_asm)
-{
-    for(PIInstruction inst : instructions) {
-        instructions_by_name[inst->getName()].push_back(inst);
-    }
-}
+    : isa(ISAHandler::get()), logger(logger), enable_liberal_asm(enable_liberal_asm)
+{ }
 
 bool Encoder::isStringPseudo(std::string const & search) const
 {
@@ -37,7 +33,7 @@ bool Encoder::isStringValidReg(std::string const & search) const
 {
     std::string lower_search = search;
     std::transform(lower_search.begin(), lower_search.end(), lower_search.begin(), ::tolower);
-    return regs.find(lower_search) != regs.end();
+    return isa.getRegs().count(lower_search) != 0;
 }
 
 bool Encoder::isValidPseudoOrig(Statement const & statement, bool log_enable) const
@@ -236,7 +232,7 @@ lc3::optional<lc3::core::PIInstruction> Encoder::validateInstruction(Statement c
         }
     }
 
-    for(auto const & candidate_inst_name : instructions_by_name) {
+    for(auto const & candidate_inst_name : isa.getInstructionsByName()) {
         uint32_t inst_name_dist = levDistance(utils::toLower(statement.base->str), candidate_inst_name.first);
         if(inst_name_dist < 2) {
             for(PIInstruction candidate_inst : candidate_inst_name.second) {
@@ -401,6 +397,8 @@ std::string Encoder::getPseudoString(Statement const & statement) const
 lc3::optional<uint32_t> Encoder::encodeInstruction(Statement const & statement, lc3::core::SymbolTable const & symbols,
     lc3::core::PIInstruction pattern) const
 {
+    SymbolTable const & regs = isa.getRegs();
+
     // The first "operand" of an instruction encoding is the op-code.
     optional<uint32_t> inst_encoding = pattern->getOperand(0)->encode(statement, *statement.base, regs, symbols, logger);
     uint32_t encoding;
@@ -448,7 +446,7 @@ uint32_t Encoder::getDistanceToNearestInstructionName(std::string const & search
     std::string lower_search = utils::toLower(search);
     uint32_t min_distance = 0;
     bool min_set = false;
-    for(auto const & inst : instructions_by_name) {
+    for(auto const & inst : isa.getInstructionsByName()) {
         uint32_t distance = levDistance(inst.first, lower_search);
         if(! min_set || distance < min_distance) {
             min_distance = distance;
@@ -13,9 +13,9 @@ void AtomicInstProcessEvent::handleEvent(MachineState & state)
 {
     (void) state;
 
-    PIMicroOp fetch = std::make_shared<FetchMicroOp>();
-    PIMicroOp inc_pc = std::make_shared<PCAddImmMicroOp>(1);
-    PIMicroOp decode = std::make_shared<DecodeMicroOp>(decoder);
+    PIMicroOp fetch = makePooled<FetchMicroOp>();
+    PIMicroOp inc_pc = makePooled<PCAddImmMicroOp>(1);
+    PIMicroOp decode = makePooled<DecodeMicroOp>(decoder);
 
     fetch->insert(inc_pc);
     inc_pc->insert(decode);
@@ -160,8 +160,10 @@ void LoadObjFileEvent::handleEvent(MachineState & state)
             fill_pc = mem.getValue();
             offset = 0;
         } else {
-            logger.printf(lc3::utils::PrintType::P_DEBUG, true, "0x%0.4x: %s (0x%0.4x)", fill_pc + offset,
-                mem.getLine().c_str(), mem.getValue());
+            if(logger.isEnabled(lc3::utils::PrintType::P_DEBUG)) {
+                logger.printf(lc3::utils::PrintType::P_DEBUG, true, "0x%0.4x: %s (0x%0.4x)", fill_pc + offset,
+                    mem.getLine().c_str(), mem.getValue());
+            }
             state.writeMem(fill_pc + offset, mem.getValue());
             state.setMemLine(fill_pc + offset, mem.getLine());
             offset += 1;
@@ -177,6 +179,37 @@ std::string LoadObjFileEvent::toString(MachineState const & state) const
     return lc3::utils::ssprintf("Loading %s into memory", filename.c_str());
 }
 
+void LoadImageEvent::handleEvent(MachineState & state)
+{
+    using namespace lc3::utils;
+
+    if(image.num_segments > 0 && image.segments[0].orig != 0) {
+        // Same as for object files: an image that starts at 0 is most likely an OS, so don't change the reset PC.
+        state.writeResetPC(image.segments[0].orig);
+    }
+
+    for(uint32_t i = 0; i < image.num_segments; i += 1) {
+        MemImageSegment const & segment = image.segments[i];
+        for(uint32_t offset = 0; offset < segment.size; offset += 1) {
+            uint16_t addr = static_cast<uint16_t>(segment.orig + offset);
+            uint16_t value = image.words[segment.offset + offset];
+            std::string line = image.lines != nullptr ? image.lines[segment.offset + offset] : "";
+            if(logger.isEnabled(PrintType::P_DEBUG)) {
+                logger.printf(PrintType::P_DEBUG, true, "0x%0.4x: %s (0x%0.4x)", addr, line.c_str(), value);
+            }
+            state.writeMem(addr, value);
+            state.setMemLine(addr, line);
+        }
+    }
+}
+
+std::string LoadImageEvent::toString(MachineState const & state) const
+{
+    (void) state;
+
+    return lc3::utils::ssprintf("Loading %s into memory", name.c_str());
+}
+
 void DeviceUpdateEvent::handleEvent(MachineState & state)
 {
     (void) state;
@@ -200,9 +233,9 @@ void CheckForInterruptEvent::handleEvent(MachineState & state)
         std::pair<PIMicroOp, PIMicroOp> handle_interrupt_chain = buildSystemModeEnter(INTEX_TABLE_START,
             getInterruptVector(interrupt), getInterruptPriority(interrupt)
         );
-        PIMicroOp dequeue_interrupt = std::make_shared<PopInterruptTypeMicroOp>();
-        PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::INT_ENTER);
-        PIMicroOp func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::INTERRUPT);
+        PIMicroOp dequeue_interrupt = makePooled<PopInterruptTypeMicroOp>();
+        PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::INT_ENTER);
+        PIMicroOp func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::INTERRUPT);
 
         handle_interrupt_chain.second->insert(dequeue_interrupt);
         dequeue_interrupt->insert(callback);
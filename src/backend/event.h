@@ -11,6 +11,7 @@
 #include "aliases.h"
 #include "callback.h"
 #include "decoder.h"
+#include "lc3os.h"
 #include "utils.h"
 
 namespace lc3
@@ -19,7 +20,7 @@ namespace core
 {
     class MachineState;
 
-    class IEvent
+    class IEvent : public PooledObject
     {
     public:
         uint64_t time;
@@ -92,6 +93,22 @@ namespace core
         lc3::utils::Logger & logger;
     };
 
+    class LoadImageEvent : public IEvent
+    {
+    public:
+        LoadImageEvent(uint64_t time, std::string const & name, MemImage const & image, lc3::utils::Logger & logger) :
+            IEvent(time), name(name), image(image), logger(logger)
+        { }
+
+        virtual void handleEvent(MachineState & state) override;
+        virtual std::string toString(MachineState const & state) const override;
+
+    private:
+        std::string name;
+        MemImage const & image;
+        lc3::utils::Logger & logger;
+    };
+
     class DeviceUpdateEvent : public IEvent
     {
     public:
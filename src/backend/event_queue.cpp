@@ -0,0 +1,97 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "event_queue.h"
+
+using namespace lc3::core;
+
+static uint32_t countTrailingZeros(uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(value);
+#else
+    uint32_t count = 0;
+    while((value & 1) == 0) {
+        value >>= 1;
+        count += 1;
+    }
+    return count;
+#endif
+}
+
+EventQueue::EventQueue(void) : occupied(0), now(0), count(0)
+{
+    for(Slot & slot : slots) {
+        slot.head = 0;
+    }
+}
+
+void EventQueue::push(PIEvent const & event)
+{
+    uint64_t time = event->time;
+    if(time >= now && time - now < NUM_SLOTS) {
+        uint32_t index = time % NUM_SLOTS;
+        slots[index].events.push_back(event);
+        occupied |= 1u << index;
+    } else {
+        // Events with equal keys are inserted after the existing ones, which keeps them in insertion order.
+        overflow.emplace(time, event);
+    }
+
+    count += 1;
+}
+
+PIEvent EventQueue::pop(void)
+{
+    // Every event on the wheel is no earlier than now, so the earliest one is in the first occupied slot at or after
+    // the slot for now.
+    bool from_wheel = false;
+    uint64_t wheel_time = 0;
+    if(occupied != 0) {
+        uint32_t start = now % NUM_SLOTS;
+        uint32_t rotated = (occupied >> start) | (occupied << ((NUM_SLOTS - start) % NUM_SLOTS));
+        wheel_time = now + countTrailingZeros(rotated);
+        from_wheel = true;
+    }
+
+    // An overflow event that ties with the wheel was scheduled first, since its time was outside the window when it
+    // was pushed.
+    PIEvent event;
+    if(! overflow.empty() && (! from_wheel || overflow.begin()->first <= wheel_time)) {
+        event = overflow.begin()->second;
+        overflow.erase(overflow.begin());
+    } else {
+        uint32_t index = wheel_time % NUM_SLOTS;
+        Slot & slot = slots[index];
+        event = slot.events[slot.head];
+        slot.head += 1;
+        if(slot.head == slot.events.size()) {
+            slot.events.clear();
+            slot.head = 0;
+            occupied &= ~(1u << index);
+        }
+    }
+
+    if(event->time > now) {
+        now = event->time;
+    }
+    count -= 1;
+    return event;
+}
+
+void EventQueue::clear(void)
+{
+    for(Slot & slot : slots) {
+        slot.events.clear();
+        slot.head = 0;
+    }
+    occupied = 0;
+    overflow.clear();
+    count = 0;
+}
+
+void EventQueue::reset(uint64_t time)
+{
+    clear();
+    now = time;
+}
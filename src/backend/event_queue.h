@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "aliases.h"
+#include "event.h"
+
+namespace lc3
+{
+namespace core
+{
+    // Orders events by time and, among events with the same time, by insertion order.  Nearly every event is
+    // scheduled within a few ticks of the current time, so events are kept on a timing wheel with one slot per tick;
+    // insertion and removal are constant time and, once the slots have grown to their working size, allocation free.
+    // The rare event that is scheduled in the past or too far into the future is kept in a separate ordered overflow.
+    class EventQueue
+    {
+    public:
+        EventQueue(void);
+
+        void push(PIEvent const & event);
+        PIEvent pop(void);
+        bool empty(void) const { return count == 0; }
+        void clear(void);
+        // Empties the queue and moves the current time to the given time, which may be earlier than before.
+        void reset(uint64_t time);
+
+    private:
+        static constexpr uint32_t NUM_SLOTS = 32;
+
+        struct Slot
+        {
+            std::vector<PIEvent> events;
+            size_t head;
+        };
+
+        std::array<Slot, NUM_SLOTS> slots;
+        uint32_t occupied;
+        std::multimap<uint64_t, PIEvent> overflow;
+        uint64_t now;
+        size_t count;
+    };
+};
+};
+
+#endif
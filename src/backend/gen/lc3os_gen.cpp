@@ -0,0 +1,132 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+// Assembles the built-in OS and writes it out as a C++ source file defining lc3::core::getOSImage, so that the OS does
+// not need to be assembled every time a simulator is created.
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "assembler.h"
+#include "lc3os.h"
+#include "mem.h"
+#include "printer.h"
+#include "utils.h"
+
+class StderrPrinter : public lc3::utils::IPrinter
+{
+public:
+    virtual void setColor(lc3::utils::PrintColor color) override { (void) color; }
+    virtual void print(std::string const & string) override { std::cerr << string; }
+    virtual void newline(void) override { std::cerr << "\n"; }
+};
+
+// Escapes a source line as the body of a C++ string literal.  Question marks are escaped so that they cannot form
+// trigraphs.
+static std::string escapeLine(std::string const & line)
+{
+    std::string ret;
+    for(char c : line) {
+        if(c == '\\' || c == '"' || c == '?') {
+            ret += '\\';
+            ret += c;
+        } else if(c >= 0x20 && c < 0x7F) {
+            ret += c;
+        } else {
+            char octal[5];
+            std::snprintf(octal, sizeof(octal), "\\%03o", static_cast<unsigned char>(c));
+            ret += octal;
+        }
+    }
+    return ret;
+}
+
+static std::string hexWord(uint16_t value)
+{
+    char hex[7];
+    std::snprintf(hex, sizeof(hex), "0x%04x", value);
+    return hex;
+}
+
+int main(int argc, char ** argv)
+{
+    if(argc != 2) {
+        std::cerr << "usage: " << argv[0] << " output.cpp\n";
+        return 1;
+    }
+
+    StderrPrinter printer;
+    lc3::core::Assembler assembler(printer, 1, false);
+    assembler.setFilename("lc3os");
+
+    std::stringstream src_buffer;
+    src_buffer << lc3::core::getOSSrc();
+    std::shared_ptr<std::stringstream> obj;
+    try {
+        obj = assembler.assemble(src_buffer).first;
+    } catch(lc3::utils::exception const & e) {
+        std::cerr << "could not assemble OS: " << e.what() << "\n";
+        return 1;
+    }
+
+    // Skip the header and version, which are only needed to validate object files.
+    std::string header_and_version = lc3::utils::getMagicHeader() + lc3::utils::getVersionString();
+    obj->seekg(header_and_version.size());
+
+    std::vector<lc3::core::MemImageSegment> segments;
+    std::vector<uint16_t> words;
+    std::vector<std::string> lines;
+    while(! obj->eof()) {
+        lc3::core::MemLocation mem;
+        *obj >> mem;
+
+        if(obj->eof()) {
+            break;
+        }
+
+        if(mem.isOrig()) {
+            segments.push_back({mem.getValue(), static_cast<uint32_t>(words.size()), 0});
+        } else if(! segments.empty()) {
+            words.push_back(mem.getValue());
+            lines.push_back(mem.getLine());
+            segments.back().size += 1;
+        }
+    }
+
+    std::ofstream out(argv[1]);
+    if(! out) {
+        std::cerr << "could not open " << argv[1] << "\n";
+        return 1;
+    }
+
+    out << "// Generated by lc3os_gen from lc3os.cpp.  Do not edit.\n";
+    out << "#include \"lc3os.h\"\n\n";
+    out << "namespace lc3\n{\nnamespace core\n{\n";
+    out << "    static constexpr MemImageSegment lc3os_segments[] = {\n";
+    for(lc3::core::MemImageSegment const & segment : segments) {
+        out << "        {" << hexWord(segment.orig) << ", " << segment.offset << ", " << segment.size << "},\n";
+    }
+    out << "    };\n\n";
+    out << "    static constexpr uint16_t lc3os_words[] = {\n";
+    for(size_t i = 0; i < words.size(); i += 1) {
+        out << (i % 12 == 0 ? "        " : " ") << hexWord(words[i]) << ",";
+        if(i % 12 == 11 || i + 1 == words.size()) {
+            out << "\n";
+        }
+    }
+    out << "    };\n\n";
+    out << "    static char const * const lc3os_lines[] = {\n";
+    for(std::string const & line : lines) {
+        out << "        \"" << escapeLine(line) << "\",\n";
+    }
+    out << "    };\n\n";
+    out << "    MemImage const & getOSImage(void)\n    {\n";
+    out << "        static MemImage const image = { lc3os_segments, " << segments.size()
+        << ", lc3os_words, lc3os_lines };\n";
+    out << "        return image;\n    }\n";
+    out << "};\n};\n";
+
+    return out ? 0 : 1;
+}
@@ -4,6 +4,9 @@
 #ifndef INPUTTER_H
 #define INPUTTER_H
 
+#include <cstdint>
+#include <limits>
+
 namespace lc3
 {
 namespace utils
@@ -18,6 +21,12 @@ namespace utils
         virtual bool getChar(char & c) = 0;
         virtual void endInput(void) = 0;
         virtual bool hasRemaining(void) const = 0;
+
+        // The number of upcoming getChar calls that are known to return no character and to have no other effect
+        // than advancing the inputter's own counters.  The simulator may skip that many calls while the keyboard is
+        // idle and report how many it skipped with skipIdleCalls.
+        virtual uint64_t getIdleCalls(void) const { return 0; }
+        virtual void skipIdleCalls(uint64_t count) { (void) count; }
     };
 
     class NullInputter : public IInputter
@@ -27,6 +36,7 @@ namespace utils
         virtual bool getChar(char &) override { return false; }
         virtual void endInput(void) override {}
         virtual bool hasRemaining(void) const override { return false; }
+        virtual uint64_t getIdleCalls(void) const override { return std::numeric_limits<uint64_t>::max(); }
     };
 };
 };
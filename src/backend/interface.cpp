@@ -16,23 +16,8 @@ lc3::sim::sim(lc3::utils::IPrinter & printer, lc3::utils::IInputter & inputter,
 {
     loadOS();
 
-    auto callback_dispatcher = std::bind(callbackDispatcher, this, std::placeholders::_1, std::placeholders::_2);
-    simulator.registerCallback(core::CallbackType::PRE_INST, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::POST_INST, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::SUB_ENTER, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::SUB_EXIT, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::EX_ENTER, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::EX_EXIT, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::INT_ENTER, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::INT_EXIT, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::BREAKPOINT, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::INPUT_REQUEST, callback_dispatcher);
-    simulator.registerCallback(core::CallbackType::INPUT_POLL, callback_dispatcher);
-
-    total_inst_exec = 0;
     cur_inst_exec_limit = 0;
     target_inst_exec = 0;
-    cur_sub_depth = 0;
 }
 
 bool lc3::sim::loadObjFile(std::string const & filename)
@@ -96,24 +81,41 @@ uint64_t lc3::sim::randomizeState(uint64_t seed)
     return seed;
 }
 
+bool lc3::sim::setCustomOS(std::string const & src)
+{
+    if(src.empty()) {
+        custom_os_obj.clear();
+    } else {
+        optional<std::string> obj = assembleOS(src);
+        if(! obj) {
+            return false;
+        }
+        custom_os_obj = *obj;
+    }
+
+    loadOS();
+    return true;
+}
+
 void lc3::sim::setRunInstLimit(uint64_t inst_limit) { cur_inst_exec_limit = inst_limit; }
 
 bool lc3::sim::run(void)
 {
-    run_type = RunType::NORMAL;
-    return runHelper();
+    return runHelper(core::StopConditions());
 }
 
 bool lc3::sim::runUntilHalt(void)
 {
-    run_type = RunType::UNTIL_HALT;
-    return runHelper();
+    core::StopConditions conditions;
+    conditions.halt = true;
+    return runHelper(conditions);
 }
 
 bool lc3::sim::runUntilInputRequested(void)
 {
-    run_type = RunType::UNTIL_INPUT_REQUESTED;
-    return runHelper();
+    core::StopConditions conditions;
+    conditions.input_request = true;
+    return runHelper(conditions);
 }
 
 void lc3::sim::asyncInterrupt(void)
@@ -123,25 +125,26 @@ void lc3::sim::asyncInterrupt(void)
 
 bool lc3::sim::stepIn(void)
 {
-    run_type = RunType::NORMAL;
     setRunInstLimit(1);
-    return runHelper();
+    return runHelper(core::StopConditions());
 }
 
 bool lc3::sim::stepOver(void)
 {
-    run_type = RunType::UNTIL_DEPTH;
-    cur_sub_depth = 0;
+    core::StopConditions conditions;
+    conditions.until_depth = true;
+    conditions.depth = 0;
     setRunInstLimit(0);
-    return runHelper();
+    return runHelper(conditions);
 }
 
 bool lc3::sim::stepOut(void)
 {
-    run_type = RunType::UNTIL_DEPTH;
-    cur_sub_depth = 1;
+    core::StopConditions conditions;
+    conditions.until_depth = true;
+    conditions.depth = 1;
     setRunInstLimit(0);
-    return runHelper();
+    return runHelper(conditions);
 }
 
 lc3::core::MachineState & lc3::sim::getMachineState(void) { return simulator.getMachineState(); }
@@ -185,10 +188,56 @@ void lc3::sim::writeCC(char value)
 
 void lc3::sim::setBreakpoint(uint16_t addr) { simulator.addBreakpoint(addr); }
 void lc3::sim::removeBreakpoint(uint16_t addr) { simulator.removeBreakpoint(addr); }
+void lc3::sim::setBreakpoints(std::vector<uint16_t> const & addrs) { simulator.addBreakpoints(addrs); }
+void lc3::sim::clearBreakpoints(void) { simulator.clearBreakpoints(); }
+std::vector<uint16_t> lc3::sim::getBreakpoints(void) const { return simulator.getBreakpoints(); }
+
+void lc3::sim::setWatchpoint(uint16_t start, uint16_t end, core::WatchpointType type)
+{
+    simulator.getMachineState().addWatchpoint(start, end, type);
+}
+
+void lc3::sim::removeWatchpoint(uint16_t start, uint16_t end, core::WatchpointType type)
+{
+    simulator.getMachineState().removeWatchpoint(start, end, type);
+}
+
+void lc3::sim::clearWatchpoints(void) { simulator.getMachineState().clearWatchpoints(); }
+
+std::vector<lc3::core::WatchpointHit> const & lc3::sim::getWatchpointHits(void) const
+{
+    return simulator.getMachineState().getWatchpointHits();
+}
+
+lc3::core::PSnapshot lc3::sim::snapshot(void) { return simulator.saveSnapshot(); }
 
-bool lc3::sim::didExceedInstLimit(void) const { return total_inst_exec == target_inst_exec; }
+void lc3::sim::restore(lc3::core::PSnapshot const & handle)
+{
+    if(handle != nullptr) {
+        simulator.restoreSnapshot(handle);
+    }
+}
+
+bool lc3::sim::didExceedInstLimit(void) const { return simulator.getInstExecCount() == target_inst_exec; }
+
+void lc3::sim::registerCallback(lc3::core::CallbackType type, lc3::sim::Callback func)
+{
+    callbacks[type] = func;
+
+    // Callbacks may be registered from within a callback, so a type is only ever subscribed to here.  Types that are
+    // no longer needed are unsubscribed before the next run.
+    if(func != nullptr && ! simulator.hasCallback(type)) {
+        simulator.registerCallback(type, [this](core::CallbackType type, core::MachineState & state) {
+            callbackDispatcher(this, type, state);
+        });
+    }
 
-void lc3::sim::registerCallback(lc3::core::CallbackType type, lc3::sim::Callback func) { callbacks[type] = func; }
+    // Per-instruction callbacks are only serviced by the detailed engine when the engine is chosen automatically.
+    auto pre_search = callbacks.find(core::CallbackType::PRE_INST);
+    auto post_search = callbacks.find(core::CallbackType::POST_INST);
+    simulator.setInstCallbacksActive((pre_search != callbacks.end() && pre_search->second != nullptr) ||
+        (post_search != callbacks.end() && post_search->second != nullptr));
+}
 
 lc3::utils::IPrinter & lc3::sim::getPrinter(void) { return printer; }
 lc3::utils::IPrinter const & lc3::sim::getPrinter(void) const { return printer; }
@@ -196,16 +245,101 @@ lc3::utils::IInputter & lc3::sim::getInputter(void) { return inputter; }
 lc3::utils::IInputter const & lc3::sim::getInputter(void) const { return inputter; }
 void lc3::sim::setPrintLevel(uint32_t print_level) { simulator.setPrintLevel(print_level); }
 void lc3::sim::setIgnorePrivilege(bool ignore_privilege) { simulator.setIgnorePrivilege(ignore_privilege); }
+void lc3::sim::setEngineType(core::EngineType type) { simulator.setEngineType(type); }
+void lc3::sim::setJITThreshold(uint32_t threshold) { simulator.setJITThreshold(threshold); }
+void lc3::sim::setJITVerify(bool verify) { simulator.setJITVerify(verify); }
+uint64_t lc3::sim::getJITVerifyFailures(void) const { return simulator.getJITVerifyFailures(); }
+
+uint64_t lc3::sim::getInstExecCount(void) const { return simulator.getInstExecCount(); }
+
+void lc3::sim::setProfiling(bool enable) { simulator.setProfiling(enable); }
+bool lc3::sim::isProfiling(void) const { return simulator.isProfiling(); }
+void lc3::sim::clearProfile(void) { simulator.clearProfile(); }
+lc3::core::Profile const * lc3::sim::getProfile(void) const { return simulator.getProfile(); }
 
-uint64_t lc3::sim::getInstExecCount(void) const { return total_inst_exec; }
+std::string lc3::sim::getFoldedStacks(void) const
+{
+    core::Profile const * profile = simulator.getProfile();
+    if(profile == nullptr) {
+        return "";
+    }
+    return profile->getFoldedStacks([this](uint32_t routine) { return getRoutineName(routine); });
+}
+
+void lc3::sim::addSymbols(core::SymbolTable const & symbols) { symbolizer.addSymbols(symbols); }
+void lc3::sim::clearSymbols(void) { symbolizer.clear(); }
+std::string lc3::sim::symbolize(uint16_t addr) const { return symbolizer.symbolize(addr); }
+
+std::string lc3::sim::getRoutineName(uint32_t routine) const
+{
+    if(routine == core::TOP_LEVEL) {
+        return "[top]";
+    }
+
+    std::string name = symbolizer.symbolize(static_cast<uint16_t>(routine));
+    return name != "" ? name : utils::ssprintf("x%0.4X", routine);
+}
+
+lc3::core::CallStack const & lc3::sim::getCallStack(void) const { return simulator.getCallStack(); }
+
+std::string lc3::sim::getBacktrace(void) const
+{
+    std::vector<core::StackFrame> frames = simulator.getCallStack().getFrames();
+    uint64_t depth = simulator.getCallStack().getDepth();
+
+    std::string ret;
+    uint16_t pc = readPC();
+    for(size_t i = 0; i <= frames.size(); i += 1) {
+        std::string routine;
+        if(i < frames.size()) {
+            routine = getRoutineName(frames[i].routine) + " [" + core::funcTypeToString(frames[i].type) + "]";
+        } else if(depth == frames.size()) {
+            routine = getRoutineName(core::TOP_LEVEL);
+        } else {
+            routine = "??";
+        }
+
+        std::string line = getMemLine(pc);
+        ret += utils::ssprintf("#%d x%0.4X in %s", static_cast<int>(i), pc, routine.c_str());
+        ret += line != "" ? " (" + line + ")\n" : "\n";
+
+        if(i < frames.size()) {
+            pc = frames[i].call_pc;
+        }
+    }
+
+    if(depth > frames.size()) {
+        ret += utils::ssprintf("... %llu more frames\n", static_cast<unsigned long long>(depth - frames.size()));
+    }
+    return ret;
+}
 
 void lc3::sim::loadOS(void)
+{
+    if(! custom_os_obj.empty()) {
+        std::stringstream obj_buffer(custom_os_obj);
+        simulator.loadObj("lc3os", obj_buffer);
+        return;
+    }
+
+#ifdef LC3_PRECOMPILED_OS
+    simulator.loadImage("lc3os", core::getOSImage());
+#else
+    optional<std::string> obj = assembleOS(core::getOSSrc());
+    if(obj) {
+        std::stringstream obj_buffer(*obj);
+        simulator.loadObj("lc3os", obj_buffer);
+    }
+#endif
+}
+
+lc3::optional<std::string> lc3::sim::assembleOS(std::string const & src)
 {
     core::Assembler assembler(printer, 0, false);
     assembler.setFilename("lc3os");
 
     std::stringstream src_buffer;
-    src_buffer << lc3::core::getOSSrc();
+    src_buffer << src;
     std::pair<std::shared_ptr<std::stringstream>, core::SymbolTable> asm_res;
     try {
         asm_res = assembler.assemble(src_buffer);
@@ -214,15 +348,17 @@ void lc3::sim::loadOS(void)
         printer.print("caught exception: " + std::string(e.what()));
         printer.newline();
 #endif
-        return;
+        return {};
     }
-    simulator.loadObj("lc3os", *(asm_res.first));
+    return asm_res.first->str();
 }
 
-bool lc3::sim::runHelper(void)
+bool lc3::sim::runHelper(core::StopConditions conditions)
 {
-    encountered_lc3_exception = false;
-    target_inst_exec = total_inst_exec + cur_inst_exec_limit;
+    conditions.inst_limit = cur_inst_exec_limit;
+    target_inst_exec = simulator.getInstExecCount() + cur_inst_exec_limit;
+    simulator.setStopConditions(conditions);
+    subscribeCallbacks();
 
 #ifdef _ENABLE_DEBUG
     auto start = std::chrono::high_resolution_clock::now();
@@ -242,63 +378,34 @@ bool lc3::sim::runHelper(void)
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = end - start;
 
-    printer.newline();
-    printer.print("elapsed time: " + std::to_string(elapsed.count() * 1000) + " ms");
-    printer.newline();
+    // This goes through the logger rather than straight to the printer so that it does not end up in the program's
+    // output unless debug messages were asked for.
+    simulator.getLogger().printf(utils::PrintType::P_DEBUG, true, "elapsed time: %f ms", elapsed.count() * 1000);
 #endif
 
-    return ! encountered_lc3_exception;
+    return ! simulator.didEncounterException();
 }
 
-void lc3::sim::callbackDispatcher(lc3::sim * sim_inst, lc3::core::CallbackType type, lc3::core::MachineState & state)
+void lc3::sim::subscribeCallbacks(void)
 {
-    using namespace lc3::core;
-
-    if(type == CallbackType::PRE_INST) {
-        if(sim_inst->run_type == RunType::UNTIL_HALT && state.readMem(state.readPC()).first == 0xf025) {
-            // Halt if current instruction is HALT.
-            sim_inst->simulator.triggerSuspend();
-        }
-    } else if(type == CallbackType::POST_INST) {
-        // Increment total instruction count
-        ++(sim_inst->total_inst_exec);
-        if(sim_inst->cur_inst_exec_limit != 0) {
-            if(sim_inst->total_inst_exec == sim_inst->target_inst_exec) {
-                // If an instruction limit is set (i.e. cur_inst_exec_limit != 0), halt when target is reached.
-                sim_inst->simulator.triggerSuspend();
-            }
-        }
-
-        if(sim_inst->run_type == RunType::UNTIL_DEPTH) {
-            if(sim_inst->cur_sub_depth == 0) {
-                sim_inst->simulator.triggerSuspend();
-            }
-        }
-    } else if(type == CallbackType::SUB_ENTER) {
-        ++(sim_inst->cur_sub_depth);
-    } else if(type == CallbackType::SUB_EXIT) {
-        if(sim_inst->cur_sub_depth > 0) {
-            --(sim_inst->cur_sub_depth);
-        }
-    } else if(type == CallbackType::EX_ENTER) {
-        // Mark that execution resulted in LC-3 exception.
-        sim_inst->encountered_lc3_exception = true;
-        ++(sim_inst->cur_sub_depth);
-    } else if(type == CallbackType::EX_EXIT) {
-        if(sim_inst->cur_sub_depth > 0) {
-            --(sim_inst->cur_sub_depth);
-        }
-    } else if(type == CallbackType::INT_ENTER) {
-        ++(sim_inst->cur_sub_depth);
-    } else if(type == CallbackType::INT_EXIT) {
-        if(sim_inst->cur_sub_depth > 0) {
-            --(sim_inst->cur_sub_depth);
-        }
-    } else if(type == CallbackType::INPUT_REQUEST) {
-        if(sim_inst->run_type == RunType::UNTIL_INPUT_REQUESTED) {
-            sim_inst->simulator.triggerSuspend();
+    // The simulator does not dispatch, or even schedule, callbacks that no one is subscribed to.  Stop conditions are
+    // handled by the simulator itself, so only types with a registered callback are subscribed to.
+    for(uint32_t i = 0; i < core::NUM_CALLBACK_TYPES; i += 1) {
+        core::CallbackType type = core::callbackIndexToType(i);
+        auto search = callbacks.find(type);
+        if(search != callbacks.end() && search->second != nullptr) {
+            simulator.registerCallback(type, [this](core::CallbackType type, core::MachineState & state) {
+                callbackDispatcher(this, type, state);
+            });
+        } else {
+            simulator.registerCallback(type, nullptr);
         }
     }
+}
+
+void lc3::sim::callbackDispatcher(lc3::sim * sim_inst, lc3::core::CallbackType type, lc3::core::MachineState & state)
+{
+    (void) state;
 
     auto search = sim_inst->callbacks.find(type);
     if(search != sim_inst->callbacks.end() && search->second != nullptr) {
@@ -18,6 +18,7 @@
 #include "assembler.h"
 #include "converter.h"
 #include "simulator.h"
+#include "symbolizer.h"
 #include "utils.h"
 
 namespace lc3
@@ -33,6 +34,7 @@ namespace lc3
         void setup(void);
         void zeroState(void);
         uint64_t randomizeState(uint64_t seed = 0);
+        bool setCustomOS(std::string const & src);
 
         void setRunInstLimit(uint64_t inst_limit);
         bool run(void);
@@ -61,6 +63,17 @@ namespace lc3
 
         void setBreakpoint(uint16_t addr);
         void removeBreakpoint(uint16_t addr);
+        void setBreakpoints(std::vector<uint16_t> const & addrs);
+        void clearBreakpoints(void);
+        std::vector<uint16_t> getBreakpoints(void) const;
+
+        void setWatchpoint(uint16_t start, uint16_t end, core::WatchpointType type);
+        void removeWatchpoint(uint16_t start, uint16_t end, core::WatchpointType type);
+        void clearWatchpoints(void);
+        std::vector<core::WatchpointHit> const & getWatchpointHits(void) const;
+
+        core::PSnapshot snapshot(void);
+        void restore(core::PSnapshot const & handle);
 
         bool didExceedInstLimit(void) const;
 
@@ -72,9 +85,35 @@ namespace lc3
         utils::IInputter const & getInputter(void) const;
         void setPrintLevel(uint32_t print_level);
         void setIgnorePrivilege(bool ignore_privilege);
+        void setEngineType(core::EngineType type);
+        void setJITThreshold(uint32_t threshold);
+        void setJITVerify(bool verify);
+        uint64_t getJITVerifyFailures(void) const;
 
         uint64_t getInstExecCount(void) const;
 
+        void setProfiling(bool enable);
+        bool isProfiling(void) const;
+        void clearProfile(void);
+        core::Profile const * getProfile(void) const;
+        // The profile's call chains in the folded format read by flame graph tools, with routines named by
+        // getRoutineName.
+        std::string getFoldedStacks(void) const;
+
+        // Symbols are only used to name addresses in reports such as profiles.  Object files do not include them, so
+        // they must be supplied from the assembler's symbol table.
+        void addSymbols(core::SymbolTable const & symbols);
+        void clearSymbols(void);
+        std::string symbolize(uint16_t addr) const;
+        // Names a routine in a profile by its label, or by its address if it has none.
+        std::string getRoutineName(uint32_t routine) const;
+
+        // Subroutines, traps, and service routines that have been entered but not yet returned from.
+        core::CallStack const & getCallStack(void) const;
+        // The call stack formatted one frame per line, innermost first, starting from the current PC.  It is built on
+        // request, so the call stack costs nothing to maintain beyond a push and pop per call.
+        std::string getBacktrace(void) const;
+
 #if (! defined API_VER) || API_VER == 1
         // Provide backward compatibility with API version.
         using callback_func_t = std::function<void(core::MachineState &)>;
@@ -134,24 +173,18 @@ namespace lc3
         utils::IPrinter & printer;
         utils::IInputter & inputter;
         core::Simulator simulator;
+        core::Symbolizer symbolizer;
 
-        enum class RunType
-        {
-              UNTIL_INPUT_REQUESTED
-            , UNTIL_HALT
-            , UNTIL_DEPTH
-            , NORMAL
-        } run_type;
-
-        bool encountered_lc3_exception;
-        uint64_t total_inst_exec;
         uint64_t cur_inst_exec_limit, target_inst_exec;
-        uint64_t cur_sub_depth;
 
         std::unordered_map<core::CallbackType, Callback> callbacks;
+        // Assembled object file for the OS set by setCustomOS, or empty to use the built-in OS.
+        std::string custom_os_obj;
 
         void loadOS(void);
-        bool runHelper(void);
+        optional<std::string> assembleOS(std::string const & src);
+        bool runHelper(core::StopConditions conditions);
+        void subscribeCallbacks(void);
         static void callbackDispatcher(sim * sim_inst, core::CallbackType type, core::MachineState & state);
     };
 
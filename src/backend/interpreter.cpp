@@ -0,0 +1,297 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "interpreter.h"
+
+#include "device_regs.h"
+#include "isa_abstract.h"
+#include "uop.h"
+#include "utils.h"
+
+using namespace lc3::core::sim;
+
+void Interpreter::step(MachineState & state) const
+{
+    // Side effects of device reads are not triggered by instruction fetches.
+    uint16_t ir = state.readMem(state.readPC()).first;
+    execute(state, ir, decoder.decode(ir));
+}
+
+void Interpreter::execute(MachineState & state, uint16_t ir, DecodedInstruction const & decoded) const
+{
+    using namespace lc3::utils;
+
+    if(isAccessViolation(state.readPC(), state)) {
+        raiseException(state, getExceptionVector(ExceptionType::ACV), false);
+        return;
+    }
+
+    state.writeIR(ir);
+    state.recordFetch(ir);
+    state.writePC(state.readPC() + 1);
+
+    if(decoded.inst == nullptr) {
+        raiseException(state, getExceptionVector(ExceptionType::ILLEGAL_OPCODE), true);
+        return;
+    }
+    state.writeDecodedIR(&decoded);
+
+    // Micro-ops returned by device accesses are executed after the rest of the instruction, just as they would be
+    // appended to the end of the instruction's micro-op chain.
+    PIMicroOp deferred = nullptr;
+
+    switch(decoded.type) {
+        case InstType::ADD_REG:
+            state.writeReg(decoded.dr, state.readReg(decoded.sr1) + state.readReg(decoded.sr2));
+            setCC(state, state.readReg(decoded.dr));
+            break;
+
+        case InstType::ADD_IMM:
+            state.writeReg(decoded.dr, state.readReg(decoded.sr1) + decoded.imm);
+            setCC(state, state.readReg(decoded.dr));
+            break;
+
+        case InstType::AND_REG:
+            state.writeReg(decoded.dr, state.readReg(decoded.sr1) & state.readReg(decoded.sr2));
+            setCC(state, state.readReg(decoded.dr));
+            break;
+
+        case InstType::AND_IMM:
+            state.writeReg(decoded.dr, state.readReg(decoded.sr1) & decoded.imm);
+            setCC(state, state.readReg(decoded.dr));
+            break;
+
+        case InstType::BR:
+            if((decoded.cc & getBits(state.readPSR(), 2, 0)) != 0) {
+                state.writePC(state.readPC() + decoded.imm);
+            }
+            break;
+
+        case InstType::JMP:
+            state.writePC(state.readReg(decoded.sr1));
+            if(decoded.sr1 == 7 && state.peekFuncTraceType() == FuncType::SUBROUTINE) {
+                state.addPendingCallback(CallbackType::SUB_EXIT);
+                state.popFuncTraceType();
+            }
+            break;
+
+        case InstType::JSR:
+            state.writeReg(7, state.readPC());
+            state.writePC(state.readPC() + decoded.imm);
+            state.addPendingCallback(CallbackType::SUB_ENTER);
+            state.pushFuncTraceType(FuncType::SUBROUTINE);
+            break;
+
+        case InstType::JSRR:
+            // R7 is written before the base register is read, so JSRR R7 jumps to the next instruction.
+            state.writeReg(7, state.readPC());
+            state.writePC(state.readReg(decoded.sr1));
+            state.addPendingCallback(CallbackType::SUB_ENTER);
+            state.pushFuncTraceType(FuncType::SUBROUTINE);
+            break;
+
+        case InstType::LD:
+        case InstType::LDI:
+        case InstType::LDR: {
+            uint16_t base = (decoded.type == InstType::LDR) ? state.readReg(decoded.sr1) : state.readPC();
+            uint16_t addr = base + decoded.imm;
+            if(! checkAccess(state, addr)) {
+                return;
+            }
+
+            uint16_t value = readMem(state, addr, deferred);
+            if(decoded.type == InstType::LDI) {
+                if(! checkAccess(state, value)) {
+                    return;
+                }
+                value = readMem(state, value, deferred);
+            }
+
+            state.writeReg(decoded.dr, value);
+            setCC(state, value);
+            break;
+        }
+
+        case InstType::LEA:
+            state.writeReg(decoded.dr, state.readPC() + decoded.imm);
+            break;
+
+        case InstType::NOT:
+            state.writeReg(decoded.dr, ~state.readReg(decoded.sr1));
+            setCC(state, state.readReg(decoded.dr));
+            break;
+
+        case InstType::RTI:
+            returnFromInterrupt(state);
+            break;
+
+        case InstType::ST:
+        case InstType::STI:
+        case InstType::STR: {
+            uint16_t base = (decoded.type == InstType::STR) ? state.readReg(decoded.sr1) : state.readPC();
+            uint16_t addr = base + decoded.imm;
+            if(decoded.type == InstType::STI) {
+                if(! checkAccess(state, addr)) {
+                    return;
+                }
+                addr = readMem(state, addr, deferred);
+            }
+
+            if(! checkAccess(state, addr)) {
+                return;
+            }
+            writeMem(state, addr, state.readReg(decoded.dr), deferred);
+            break;
+        }
+
+        case InstType::TRAP:
+            enterSystemMode(state, TRAP_TABLE_START, decoded.vec, (state.readPSR() & 0x0700) >> 8);
+            state.addPendingCallback(CallbackType::SUB_ENTER);
+            state.pushFuncTraceType(FuncType::TRAP);
+            break;
+
+        default:
+            break;
+    }
+
+    executeMicroOps(state, deferred);
+}
+
+bool Interpreter::checkForInterrupt(MachineState & state) const
+{
+    InterruptType interrupt = state.peekInterrupt();
+    if(interrupt == InterruptType::INVALID ||
+        getInterruptPriority(interrupt) <= lc3::utils::getBits(state.readPSR(), 10, 8))
+    {
+        return false;
+    }
+
+    enterSystemMode(state, INTEX_TABLE_START, getInterruptVector(interrupt), getInterruptPriority(interrupt));
+    state.dequeueInterrupt();
+    state.addPendingCallback(CallbackType::INT_ENTER);
+    state.pushFuncTraceType(FuncType::INTERRUPT);
+    return true;
+}
+
+void Interpreter::executeMicroOps(MachineState & state, PIMicroOp uops)
+{
+    while(uops != nullptr) {
+        uops->handleMicroOp(state);
+        uops = uops->getNext();
+    }
+}
+
+uint16_t Interpreter::readMem(MachineState & state, uint16_t addr, PIMicroOp & deferred) const
+{
+    std::pair<uint16_t, PIMicroOp> read_result = state.loadMem(addr);
+    if(read_result.second != nullptr) {
+        if(deferred == nullptr) {
+            deferred = read_result.second;
+        } else {
+            deferred->insert(read_result.second);
+        }
+    }
+    return read_result.first;
+}
+
+void Interpreter::writeMem(MachineState & state, uint16_t addr, uint16_t value, PIMicroOp & deferred) const
+{
+    PIMicroOp op = state.storeMem(addr, value);
+    if(op != nullptr) {
+        if(deferred == nullptr) {
+            deferred = op;
+        } else {
+            deferred->insert(op);
+        }
+    }
+}
+
+bool Interpreter::checkAccess(MachineState & state, uint16_t addr) const
+{
+    if(isAccessViolation(addr, state)) {
+        raiseException(state, getExceptionVector(ExceptionType::ACV), true);
+        return false;
+    }
+
+    return true;
+}
+
+void Interpreter::setCC(MachineState & state, uint16_t value) const
+{
+    uint16_t psr_value = state.readPSR() & 0xFFF8;
+    if(lc3::utils::getBit(value, 15) == 1) {
+        state.writePSR(psr_value | 0x0004);
+    } else if(value == 0) {
+        state.writePSR(psr_value | 0x0002);
+    } else {
+        state.writePSR(psr_value | 0x0001);
+    }
+}
+
+void Interpreter::enterSystemMode(MachineState & state, uint16_t table_start, uint8_t vec, uint8_t priority) const
+{
+    uint16_t old_psr = state.readPSR();
+    if(lc3::utils::getBit(old_psr, 15) == 1) {
+        uint16_t user_sp = state.readReg(6);
+        state.writeReg(6, state.readSSP());
+        state.writeSSP(user_sp);
+    }
+
+    // Matches buildSystemModeEnter, including the priority mask.
+    uint16_t new_psr = (old_psr & 0xF1FF) + ((priority & 0x7) << 8);
+    state.writePSR(new_psr & 0x7FFF);
+
+    PIMicroOp deferred = nullptr;
+    state.writeReg(6, state.readReg(6) - 1);
+    writeMem(state, state.readReg(6), old_psr, deferred);
+    state.writeReg(6, state.readReg(6) - 1);
+    writeMem(state, state.readReg(6), state.readPC(), deferred);
+    state.writePC(readMem(state, table_start + vec, deferred));
+    executeMicroOps(state, deferred);
+}
+
+void Interpreter::raiseException(MachineState & state, uint8_t vec, bool rewind_pc) const
+{
+    if(rewind_pc) {
+        state.writePC(state.readPC() - 1);
+    }
+
+    enterSystemMode(state, INTEX_TABLE_START, vec, lc3::utils::getBits(state.readPSR(), 10, 8));
+    state.addPendingCallback(CallbackType::EX_ENTER);
+    state.pushFuncTraceType(FuncType::EXCEPTION);
+}
+
+void Interpreter::returnFromInterrupt(MachineState & state) const
+{
+    if(lc3::utils::getBit(state.readPSR(), 15) == 1) {
+        raiseException(state, getExceptionVector(ExceptionType::PRIVILEGE_MODE), true);
+        return;
+    }
+
+    FuncType func_type = state.peekFuncTraceType();
+
+    // Side effects of device reads are dropped, as they are in the micro-op chain for RTI.
+    state.writePC(state.loadMem(state.readReg(6)).first);
+    state.writeReg(6, state.readReg(6) + 1);
+    state.writePSR(state.loadMem(state.readReg(6)).first);
+    state.writeReg(6, state.readReg(6) + 1);
+
+    if(lc3::utils::getBit(state.readPSR(), 15) == 1) {
+        uint16_t system_sp = state.readReg(6);
+        state.writeReg(6, state.readSSP());
+        state.writeSSP(system_sp);
+    }
+
+    CallbackType callback = CallbackType::INVALID;
+    switch(func_type) {
+        case FuncType::TRAP: callback = CallbackType::SUB_EXIT; break;
+        case FuncType::INTERRUPT: callback = CallbackType::INT_EXIT; break;
+        case FuncType::EXCEPTION: callback = CallbackType::EX_EXIT; break;
+        default: break;
+    }
+
+    if(callback != CallbackType::INVALID) {
+        state.addPendingCallback(callback);
+        state.popFuncTraceType();
+    }
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+#include <cstdint>
+
+#include "aliases.h"
+#include "decoder.h"
+#include "state.h"
+
+namespace lc3
+{
+namespace core
+{
+namespace sim
+{
+    // Executes instructions directly against the machine state instead of building and dispatching micro-ops.  The
+    // architectural effects (registers, memory, PSR, device accesses, pending callbacks, and the function trace) are
+    // identical to those produced by the micro-op chains in isa_impl.cpp.
+    class Interpreter
+    {
+    public:
+        Interpreter(void) = default;
+
+        void step(MachineState & state) const;
+        void execute(MachineState & state, uint16_t ir, DecodedInstruction const & decoded) const;
+        bool checkForInterrupt(MachineState & state) const;
+
+        static void executeMicroOps(MachineState & state, PIMicroOp uops);
+
+    private:
+        Decoder decoder;
+
+        bool checkAccess(MachineState & state, uint16_t addr) const;
+        uint16_t readMem(MachineState & state, uint16_t addr, PIMicroOp & deferred) const;
+        void writeMem(MachineState & state, uint16_t addr, uint16_t value, PIMicroOp & deferred) const;
+        void setCC(MachineState & state, uint16_t value) const;
+        void enterSystemMode(MachineState & state, uint16_t table_start, uint8_t vec, uint8_t priority) const;
+        void raiseException(MachineState & state, uint8_t vec, bool rewind_pc) const;
+        void returnFromInterrupt(MachineState & state) const;
+    };
+};
+};
+};
+
+#endif
@@ -21,28 +21,32 @@ namespace core
     {
     public:
         ADDRegInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class ADDImmInstruction : public IInstruction
     {
     public:
         ADDImmInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class ANDRegInstruction : public IInstruction
     {
     public:
         ANDRegInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class ANDImmInstruction : public IInstruction
     {
     public:
         ANDImmInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class BRInstruction : public IInstruction
@@ -51,7 +55,8 @@ namespace core
         using IInstruction::IInstruction;
 
         BRInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class BRzInstruction : public BRInstruction
@@ -114,56 +119,64 @@ namespace core
         using IInstruction::IInstruction;
 
         JMPInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class JSRRInstruction : public IInstruction
     {
     public:
         JSRRInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class JSRInstruction : public IInstruction
     {
     public:
         JSRInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class LDInstruction : public IInstruction
     {
     public:
         LDInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class LDIInstruction : public IInstruction
     {
     public:
         LDIInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class LDRInstruction : public IInstruction
     {
     public:
         LDRInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class LEAInstruction : public IInstruction
     {
     public:
         LEAInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class NOTInstruction : public IInstruction
     {
     public:
         NOTInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class RETInstruction : public JMPInstruction
@@ -176,28 +189,32 @@ namespace core
     {
     public:
         RTIInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class STInstruction : public IInstruction
     {
     public:
         STInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class STIInstruction : public IInstruction
     {
     public:
         STIInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class STRInstruction : public IInstruction
     {
     public:
         STRInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class TRAPInstruction : public IInstruction
@@ -206,7 +223,8 @@ namespace core
         using IInstruction::IInstruction;
 
         TRAPInstruction(void);
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const override;
+        virtual PIMicroOp buildMicroOps(MachineState const & state,
+            sim::DecodedInstruction const & decoded) const override;
     };
 
     class GETCInstruction : public TRAPInstruction
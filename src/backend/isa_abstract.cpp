@@ -57,7 +57,7 @@ std::string IInstruction::toFormatString(void) const
     return assembly.str();
 }
 
-std::string IInstruction::toValueString(void) const
+std::string IInstruction::toValueString(uint16_t value) const
 {
     std::stringstream assembly;
     assembly << name;
@@ -65,22 +65,26 @@ std::string IInstruction::toValueString(void) const
         assembly << " ";
     }
     std::string prefix = "";
+    uint32_t bit_pos = 15;
     for(PIOperand operand : operands) {
+        uint16_t operand_value = lc3::utils::getBits(value, bit_pos, bit_pos - operand->getWidth() + 1);
+        bit_pos -= operand->getWidth();
+
         if(operand->getType() != IOperand::Type::FIXED) {
             std::string oper_str;
             if(operand->getType() == IOperand::Type::NUM || operand->getType() == IOperand::Type::LABEL) {
                 if((operand->getType() == IOperand::Type::NUM &&
-                        std::static_pointer_cast<NumOperand>(operand)->shouldSEXT()) ||
+                        std::static_pointer_cast<NumOperand const>(operand)->shouldSEXT()) ||
                     operand->getType() == IOperand::Type::LABEL)
                 {
                     oper_str = "#" + std::to_string(static_cast<uint16_t>(
-                        lc3::utils::sextTo32(operand->getValue(), operand->getWidth())
+                        lc3::utils::sextTo32(operand_value, operand->getWidth())
                     ));
                 } else {
-                    oper_str = "#" + std::to_string(operand->getValue());
+                    oper_str = "#" + std::to_string(operand_value);
                 }
             } else if(operand->getType() == IOperand::Type::REG) {
-                oper_str = "r" + std::to_string(operand->getValue());
+                oper_str = "r" + std::to_string(operand_value);
             }
             assembly << prefix << oper_str;
             prefix = ", ";
@@ -90,7 +94,7 @@ std::string IInstruction::toValueString(void) const
 }
 
 lc3::optional<uint32_t> FixedOperand::encode(asmbl::Statement const & statement, asmbl::StatementPiece const & piece,
-    SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger)
+    SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger) const
 {
     (void) statement;
     (void) piece;
@@ -102,7 +106,7 @@ lc3::optional<uint32_t> FixedOperand::encode(asmbl::Statement const & statement,
 }
 
 lc3::optional<uint32_t> RegOperand::encode(asmbl::Statement const & statement, asmbl::StatementPiece const & piece,
-    SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger)
+    SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger) const
 {
     using namespace lc3::utils;
 
@@ -117,7 +121,7 @@ lc3::optional<uint32_t> RegOperand::encode(asmbl::Statement const & statement, a
 }
 
 lc3::optional<uint32_t> NumOperand::encode(asmbl::Statement const & statement, asmbl::StatementPiece const & piece,
-    SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger)
+    SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger) const
 {
     using namespace lc3::utils;
 
@@ -136,7 +140,7 @@ lc3::optional<uint32_t> NumOperand::encode(asmbl::Statement const & statement, a
 }
 
 lc3::optional<uint32_t> LabelOperand::encode(asmbl::Statement const & statement, asmbl::StatementPiece const & piece,
-    SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger)
+    SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger) const
 {
     using namespace lc3::utils;
     using namespace asmbl;
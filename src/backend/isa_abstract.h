@@ -4,7 +4,9 @@
 #ifndef ISA_ABSTRACT_H
 #define ISA_ABSTRACT_H
 
+#include <map>
 #include <string>
+#include <vector>
 
 #include "aliases.h"
 #include "asm_types.h"
@@ -15,16 +17,27 @@ namespace lc3
 {
 namespace core
 {
+    namespace sim { struct DecodedInstruction; };
+
+    // The instruction set is built once per process and never modified afterwards, so it is shared by every decoder
+    // and encoder and may be used from any number of threads.
     class ISAHandler
     {
     public:
-        ISAHandler(void);
-        virtual ~ISAHandler(void) = default;
+        static ISAHandler const & get(void);
 
-        SymbolTable const & getRegs(void) { return regs; }
+        std::vector<PIInstruction> const & getInstructions(void) const { return instructions; }
+        std::map<std::string, std::vector<PIInstruction>> const & getInstructionsByName(void) const
+        {
+            return instructions_by_name;
+        }
+        SymbolTable const & getRegs(void) const { return regs; }
+
+    private:
+        ISAHandler(void);
 
-    protected:
         std::vector<PIInstruction> instructions;
+        std::map<std::string, std::vector<PIInstruction>> instructions_by_name;
         SymbolTable regs;
     };
 
@@ -43,14 +56,13 @@ namespace core
         virtual ~IOperand(void) = default;
 
         virtual optional<uint32_t> encode(asmbl::Statement const & statement, asmbl::StatementPiece const & piece,
-            SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger) = 0;
+            SymbolTable const & regs, SymbolTable const & symbols, lc3::utils::AssemblerLogger & logger) const = 0;
         bool isEqualType(Type other) const;
 
         Type getType(void) const { return type; }
         std::string const & getTypeString(void) const { return type_str; }
         uint32_t getWidth(void) const { return width; }
         uint16_t getValue(void) const { return value; }
-        void setValue(uint16_t new_value) { value = new_value; }
 
     protected:
         Type type;
@@ -59,7 +71,7 @@ namespace core
         std::string type_str;
         uint32_t width;
 
-        // Used by simulator.
+        // Used by decoder to match fixed operands.
         uint16_t value;
     };
 
@@ -70,9 +82,9 @@ namespace core
         IInstruction(IInstruction const & that);
         virtual ~IInstruction(void) = default;
 
-        virtual PIMicroOp buildMicroOps(MachineState const & state) const = 0;
+        virtual PIMicroOp buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const = 0;
         std::string toFormatString(void) const;
-        std::string toValueString(void) const;
+        std::string toValueString(uint16_t value) const;
 
         std::string const & getName(void) const { return name; }
         std::vector<PIOperand> const & getOperands(void) const { return operands; }
@@ -88,7 +100,7 @@ namespace core
     public:
         FixedOperand(uint32_t width, uint32_t value);
         virtual optional<uint32_t> encode(asmbl::Statement const & statement, asmbl::StatementPiece const & piece,
-            SymbolTable const & regs, SymbolTable const & symbols, utils::AssemblerLogger & logger) override;
+            SymbolTable const & regs, SymbolTable const & symbols, utils::AssemblerLogger & logger) const override;
     };
 
     class RegOperand : public IOperand
@@ -96,7 +108,7 @@ namespace core
     public:
         RegOperand(uint32_t width);
         virtual optional<uint32_t> encode(asmbl::Statement const & statement, asmbl::StatementPiece const & piece,
-            SymbolTable const & regs, SymbolTable const & symbols, utils::AssemblerLogger & logger) override;
+            SymbolTable const & regs, SymbolTable const & symbols, utils::AssemblerLogger & logger) const override;
     };
 
     class NumOperand : public IOperand
@@ -104,7 +116,7 @@ namespace core
     public:
         NumOperand(uint32_t width, bool sext);
         virtual optional<uint32_t> encode(asmbl::Statement const & statement, asmbl::StatementPiece const & piece,
-            SymbolTable const & regs, SymbolTable const & symbols, utils::AssemblerLogger & logger) override;
+            SymbolTable const & regs, SymbolTable const & symbols, utils::AssemblerLogger & logger) const override;
         bool shouldSEXT(void) const { return sext; }
 
     private:
@@ -116,7 +128,7 @@ namespace core
     public:
         LabelOperand(uint32_t width);
         virtual optional<uint32_t> encode(asmbl::Statement const & statement, asmbl::StatementPiece const & piece,
-            SymbolTable const & regs, SymbolTable const & symbols, utils::AssemblerLogger & logger) override;
+            SymbolTable const & regs, SymbolTable const & symbols, utils::AssemblerLogger & logger) const override;
     };
 };
 };
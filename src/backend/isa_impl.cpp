@@ -1,6 +1,7 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include "decoder.h"
 #include "isa.h"
 
 using namespace lc3::core;
@@ -51,98 +52,103 @@ ISAHandler::ISAHandler(void)
     instructions.push_back(std::make_shared<INInstruction>());
     instructions.push_back(std::make_shared<PUTSPInstruction>());
     instructions.push_back(std::make_shared<HALTInstruction>());
+
+    for(PIInstruction inst : instructions) {
+        instructions_by_name[inst->getName()].push_back(inst);
+    }
+}
+
+ISAHandler const & ISAHandler::get(void)
+{
+    static ISAHandler const isa;
+    return isa;
 }
 
-PIMicroOp ADDRegInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp ADDRegInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t dst_id = getOperand(1)->getValue();
-    PIMicroOp compute = std::make_shared<RegAddRegMicroOp>(dst_id, getOperand(2)->getValue(),
-        getOperand(4)->getValue());
-    PIMicroOp set_cc = std::make_shared<CCUpdateRegMicroOp>(dst_id);
+    uint16_t dst_id = decoded.dr;
+    PIMicroOp compute = makePooled<RegAddRegMicroOp>(dst_id, decoded.sr1, decoded.sr2);
+    PIMicroOp set_cc = makePooled<CCUpdateRegMicroOp>(dst_id);
 
     compute->insert(set_cc);
     return compute;
 }
 
-PIMicroOp ADDImmInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp ADDImmInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t dst_id = getOperand(1)->getValue();
-    PIMicroOp compute = std::make_shared<RegAddImmMicroOp>(dst_id, getOperand(2)->getValue(),
-        lc3::utils::sextTo16(getOperand(4)->getValue(), getOperand(4)->getWidth()));
-    PIMicroOp set_cc = std::make_shared<CCUpdateRegMicroOp>(dst_id);
+    uint16_t dst_id = decoded.dr;
+    PIMicroOp compute = makePooled<RegAddImmMicroOp>(dst_id, decoded.sr1, decoded.imm);
+    PIMicroOp set_cc = makePooled<CCUpdateRegMicroOp>(dst_id);
 
     compute->insert(set_cc);
     return compute;
 }
 
-PIMicroOp ANDRegInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp ANDRegInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t dst_id = getOperand(1)->getValue();
-    PIMicroOp compute = std::make_shared<RegAndRegMicroOp>(dst_id, getOperand(2)->getValue(),
-        getOperand(4)->getValue());
-    PIMicroOp set_cc =std::make_shared<CCUpdateRegMicroOp>(dst_id);
+    uint16_t dst_id = decoded.dr;
+    PIMicroOp compute = makePooled<RegAndRegMicroOp>(dst_id, decoded.sr1, decoded.sr2);
+    PIMicroOp set_cc =makePooled<CCUpdateRegMicroOp>(dst_id);
 
     compute->insert(set_cc);
     return compute;
 }
 
-PIMicroOp ANDImmInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp ANDImmInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t dst_id = getOperand(1)->getValue();
-    PIMicroOp compute = std::make_shared<RegAndImmMicroOp>(dst_id, getOperand(2)->getValue(),
-        lc3::utils::sextTo16(getOperand(4)->getValue(), getOperand(4)->getWidth()));
-    PIMicroOp set_cc = std::make_shared<CCUpdateRegMicroOp>(dst_id);
+    uint16_t dst_id = decoded.dr;
+    PIMicroOp compute = makePooled<RegAndImmMicroOp>(dst_id, decoded.sr1, decoded.imm);
+    PIMicroOp set_cc = makePooled<CCUpdateRegMicroOp>(dst_id);
 
     compute->insert(set_cc);
     return compute;
 }
 
-PIMicroOp BRInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp BRInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    PIMicroOp jump = std::make_shared<PCAddImmMicroOp>(lc3::utils::sextTo16(getOperand(2)->getValue(),
-        getOperand(2)->getWidth()));
+    uint16_t cc = decoded.cc;
+    PIMicroOp jump = makePooled<PCAddImmMicroOp>(decoded.imm);
 
-    return std::make_shared<BranchMicroOp>([this](MachineState const & state) {
-        return (getOperand(1)->getValue() & lc3::utils::getBits(state.readPSR(), 2, 0)) != 0;
+    return makePooled<BranchMicroOp>([cc](MachineState const & state) {
+        return (cc & lc3::utils::getBits(state.readPSR(), 2, 0)) != 0;
     }, "(N&n) | (Z&z) | (P&p)", jump, nullptr);
 }
 
-PIMicroOp JMPInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp JMPInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t reg_id = getOperand(2)->getValue();
-    PIMicroOp jump = std::make_shared<PCWriteRegMicroOp>(reg_id);
-    PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::SUB_EXIT);
-    PIMicroOp func_trace = std::make_shared<PopFuncTypeMicroOp>();
+    uint16_t reg_id = decoded.sr1;
+    PIMicroOp jump = makePooled<PCWriteRegMicroOp>(reg_id);
+    PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::SUB_EXIT);
+    PIMicroOp func_trace = makePooled<PopFuncTypeMicroOp>();
 
-    jump->insert(std::make_shared<BranchMicroOp>([this](MachineState const & state) {
-        return (getOperand(2)->getValue() == 7 && state.peekFuncTraceType() == FuncType::SUBROUTINE);
+    jump->insert(makePooled<BranchMicroOp>([reg_id](MachineState const & state) {
+        return (reg_id == 7 && state.peekFuncTraceType() == FuncType::SUBROUTINE);
     }, "funcTrace.top() == subroutine", callback, nullptr));
     callback->insert(func_trace);
 
     return jump;
 }
 
-PIMicroOp JSRInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp JSRInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    PIMicroOp link = std::make_shared<RegWritePCMicroOp>(7);
-    PIMicroOp jump = std::make_shared<PCAddImmMicroOp>(lc3::utils::sextTo16(getOperand(2)->getValue(),
-        getOperand(2)->getWidth()));
-    PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::SUB_ENTER);
-    PIMicroOp func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::SUBROUTINE);
+    PIMicroOp link = makePooled<RegWritePCMicroOp>(7);
+    PIMicroOp jump = makePooled<PCAddImmMicroOp>(decoded.imm);
+    PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::SUB_ENTER);
+    PIMicroOp func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::SUBROUTINE);
 
     link->insert(jump);
     jump->insert(callback);
@@ -150,14 +156,14 @@ PIMicroOp JSRInstruction::buildMicroOps(MachineState const & state) const
     return link;
 }
 
-PIMicroOp JSRRInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp JSRRInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    PIMicroOp link = std::make_shared<RegWritePCMicroOp>(7);
-    PIMicroOp jump = std::make_shared<PCWriteRegMicroOp>(getOperand(3)->getValue());
-    PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::SUB_ENTER);
-    PIMicroOp func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::SUBROUTINE);
+    PIMicroOp link = makePooled<RegWritePCMicroOp>(7);
+    PIMicroOp jump = makePooled<PCWriteRegMicroOp>(decoded.sr1);
+    PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::SUB_ENTER);
+    PIMicroOp func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::SUBROUTINE);
 
     link->insert(jump);
     jump->insert(callback);
@@ -165,16 +171,15 @@ PIMicroOp JSRRInstruction::buildMicroOps(MachineState const & state) const
     return link;
 }
 
-PIMicroOp LDInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp LDInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t dst_id = getOperand(1)->getValue();
-    PIMicroOp write_pc = std::make_shared<RegWritePCMicroOp>(8);
-    PIMicroOp compute_addr = std::make_shared<RegAddImmMicroOp>(8, 8,
-        lc3::utils::sextTo16(getOperand(2)->getValue(), getOperand(2)->getWidth()));
-    PIMicroOp load = std::make_shared<MemReadMicroOp>(dst_id, 8);
-    PIMicroOp set_cc = std::make_shared<CCUpdateRegMicroOp>(dst_id);
+    uint16_t dst_id = decoded.dr;
+    PIMicroOp write_pc = makePooled<RegWritePCMicroOp>(8);
+    PIMicroOp compute_addr = makePooled<RegAddImmMicroOp>(8, 8, decoded.imm);
+    PIMicroOp load = makePooled<MemReadMicroOp>(dst_id, 8);
+    PIMicroOp set_cc = makePooled<CCUpdateRegMicroOp>(dst_id);
 
     write_pc->insert(compute_addr);
     compute_addr->insert(load);
@@ -182,17 +187,16 @@ PIMicroOp LDInstruction::buildMicroOps(MachineState const & state) const
     return write_pc;
 }
 
-PIMicroOp LDIInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp LDIInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t dst_id = getOperand(1)->getValue();
-    PIMicroOp write_pc = std::make_shared<RegWritePCMicroOp>(8);
-    PIMicroOp compute_addr = std::make_shared<RegAddImmMicroOp>(8, 8,
-        lc3::utils::sextTo16(getOperand(2)->getValue(), getOperand(2)->getWidth()));
-    PIMicroOp load1 = std::make_shared<MemReadMicroOp>(8, 8);
-    PIMicroOp load2 = std::make_shared<MemReadMicroOp>(dst_id, 8);
-    PIMicroOp set_cc = std::make_shared<CCUpdateRegMicroOp>(dst_id);
+    uint16_t dst_id = decoded.dr;
+    PIMicroOp write_pc = makePooled<RegWritePCMicroOp>(8);
+    PIMicroOp compute_addr = makePooled<RegAddImmMicroOp>(8, 8, decoded.imm);
+    PIMicroOp load1 = makePooled<MemReadMicroOp>(8, 8);
+    PIMicroOp load2 = makePooled<MemReadMicroOp>(dst_id, 8);
+    PIMicroOp set_cc = makePooled<CCUpdateRegMicroOp>(dst_id);
 
     write_pc->insert(compute_addr);
     compute_addr->insert(load1);
@@ -201,17 +205,16 @@ PIMicroOp LDIInstruction::buildMicroOps(MachineState const & state) const
     return write_pc;
 }
 
-PIMicroOp LDRInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp LDRInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t dst_id = getOperand(1)->getValue();
-    uint16_t base_id = getOperand(2)->getValue();
-    PIMicroOp write_base = std::make_shared<RegWriteRegMicroOp>(8, base_id);
-    PIMicroOp compute_addr = std::make_shared<RegAddImmMicroOp>(8, 8,
-        lc3::utils::sextTo16(getOperand(3)->getValue(), getOperand(3)->getWidth()));
-    PIMicroOp load = std::make_shared<MemReadMicroOp>(dst_id, 8);
-    PIMicroOp set_cc = std::make_shared<CCUpdateRegMicroOp>(dst_id);
+    uint16_t dst_id = decoded.dr;
+    uint16_t base_id = decoded.sr1;
+    PIMicroOp write_base = makePooled<RegWriteRegMicroOp>(8, base_id);
+    PIMicroOp compute_addr = makePooled<RegAddImmMicroOp>(8, 8, decoded.imm);
+    PIMicroOp load = makePooled<MemReadMicroOp>(dst_id, 8);
+    PIMicroOp set_cc = makePooled<CCUpdateRegMicroOp>(dst_id);
 
     write_base->insert(compute_addr);
     compute_addr->insert(load);
@@ -219,60 +222,61 @@ PIMicroOp LDRInstruction::buildMicroOps(MachineState const & state) const
     return write_base;
 }
 
-PIMicroOp LEAInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp LEAInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t dst_id = getOperand(1)->getValue();
-    PIMicroOp write_pc = std::make_shared<RegWritePCMicroOp>(8);
-    PIMicroOp compute_addr = std::make_shared<RegAddImmMicroOp>(dst_id, 8,
-        lc3::utils::sextTo16(getOperand(2)->getValue(), getOperand(2)->getWidth()));
+    uint16_t dst_id = decoded.dr;
+    PIMicroOp write_pc = makePooled<RegWritePCMicroOp>(8);
+    PIMicroOp compute_addr = makePooled<RegAddImmMicroOp>(dst_id, 8, decoded.imm);
 
     write_pc->insert(compute_addr);
     return write_pc;
 }
 
-PIMicroOp NOTInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp NOTInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t dst_id = getOperand(1)->getValue();
-    PIMicroOp compute = std::make_shared<RegNotMicroOp>(dst_id, getOperand(2)->getValue());
-    PIMicroOp set_cc = std::make_shared<CCUpdateRegMicroOp>(dst_id);
+    uint16_t dst_id = decoded.dr;
+    PIMicroOp compute = makePooled<RegNotMicroOp>(dst_id, decoded.sr1);
+    PIMicroOp set_cc = makePooled<CCUpdateRegMicroOp>(dst_id);
 
     compute->insert(set_cc);
     return compute;
 }
 
-PIMicroOp RTIInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp RTIInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
-    PIMicroOp msg = std::make_shared<PrintMessageMicroOp>("privilege violation");
-    PIMicroOp dec_pc = std::make_shared<PCAddImmMicroOp>(-1);
+    (void) decoded;
+
+    PIMicroOp msg = makePooled<PrintMessageMicroOp>("privilege violation");
+    PIMicroOp dec_pc = makePooled<PCAddImmMicroOp>(-1);
     std::pair<PIMicroOp, PIMicroOp> handle_exception_chain = buildSystemModeEnter(INTEX_TABLE_START, 0x0,
         lc3::utils::getBits(state.readPSR(), 10, 8));
-    PIMicroOp ex_callback = std::make_shared<CallbackMicroOp>(CallbackType::EX_ENTER);
-    PIMicroOp ex_func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
-
-    PIMicroOp load_pc = std::make_shared<MemReadMicroOp>(8, 6);
-    PIMicroOp write_pc = std::make_shared<PCWriteRegMicroOp>(8);
-    PIMicroOp dec_sp1 = std::make_shared<RegAddImmMicroOp>(6, 6, 1);
-    PIMicroOp load_psr = std::make_shared<MemReadMicroOp>(8, 6);
-    PIMicroOp write_psr = std::make_shared<PSRWriteRegMicroOp>(8);
-    PIMicroOp dec_sp2 = std::make_shared<RegAddImmMicroOp>(6, 6, 1);
-    PIMicroOp save_cur_sp = std::make_shared<RegWriteRegMicroOp>(9, 6);
-    PIMicroOp write_ssp = std::make_shared<RegWriteSSPMicroOp>(6);
-    PIMicroOp write_cur_sp = std::make_shared<SSPWriteRegMicroOp>(9);
+    PIMicroOp ex_callback = makePooled<CallbackMicroOp>(CallbackType::EX_ENTER);
+    PIMicroOp ex_func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
+
+    PIMicroOp load_pc = makePooled<MemReadMicroOp>(8, 6);
+    PIMicroOp write_pc = makePooled<PCWriteRegMicroOp>(8);
+    PIMicroOp dec_sp1 = makePooled<RegAddImmMicroOp>(6, 6, 1);
+    PIMicroOp load_psr = makePooled<MemReadMicroOp>(8, 6);
+    PIMicroOp write_psr = makePooled<PSRWriteRegMicroOp>(8);
+    PIMicroOp dec_sp2 = makePooled<RegAddImmMicroOp>(6, 6, 1);
+    PIMicroOp save_cur_sp = makePooled<RegWriteRegMicroOp>(9, 6);
+    PIMicroOp write_ssp = makePooled<RegWriteSSPMicroOp>(6);
+    PIMicroOp write_cur_sp = makePooled<SSPWriteRegMicroOp>(9);
 
     PIMicroOp callback = nullptr;
     switch(state.peekFuncTraceType()) {
-        case FuncType::TRAP: callback = std::make_shared<CallbackMicroOp>(CallbackType::SUB_EXIT); break;
-        case FuncType::INTERRUPT: callback = std::make_shared<CallbackMicroOp>(CallbackType::INT_EXIT); break;
-        case FuncType::EXCEPTION: callback = std::make_shared<CallbackMicroOp>(CallbackType::EX_EXIT); break;
+        case FuncType::TRAP: callback = makePooled<CallbackMicroOp>(CallbackType::SUB_EXIT); break;
+        case FuncType::INTERRUPT: callback = makePooled<CallbackMicroOp>(CallbackType::INT_EXIT); break;
+        case FuncType::EXCEPTION: callback = makePooled<CallbackMicroOp>(CallbackType::EX_EXIT); break;
         default: break;
     }
-    PIMicroOp func_trace = std::make_shared<PopFuncTypeMicroOp>();
+    PIMicroOp func_trace = makePooled<PopFuncTypeMicroOp>();
 
-    PIMicroOp start = std::make_shared<BranchMicroOp>([](MachineState const & state) {
+    PIMicroOp start = makePooled<BranchMicroOp>([](MachineState const & state) {
         return lc3::utils::getBit(state.readPSR(), 15) == 0;
     }, "PSR[15] == 0", load_pc, msg);
 
@@ -286,7 +290,7 @@ PIMicroOp RTIInstruction::buildMicroOps(MachineState const & state) const
     dec_sp1->insert(load_psr);
     load_psr->insert(write_psr);
     write_psr->insert(dec_sp2);
-    dec_sp2->insert(std::make_shared<BranchMicroOp>([](MachineState const & state) {
+    dec_sp2->insert(makePooled<BranchMicroOp>([](MachineState const & state) {
         return lc3::utils::getBit(state.readPSR(), 15) == 0;
     }, "PSR[15] == 0", callback, save_cur_sp));
 
@@ -300,31 +304,29 @@ PIMicroOp RTIInstruction::buildMicroOps(MachineState const & state) const
     return start;
 }
 
-PIMicroOp STInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp STInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t src_id = getOperand(1)->getValue();
-    PIMicroOp write_pc = std::make_shared<RegWritePCMicroOp>(8);
-    PIMicroOp compute_addr = std::make_shared<RegAddImmMicroOp>(8, 8,
-        lc3::utils::sextTo16(getOperand(2)->getValue(), getOperand(2)->getWidth()));
-    PIMicroOp store = std::make_shared<MemWriteRegMicroOp>(8, src_id);
+    uint16_t src_id = decoded.dr;
+    PIMicroOp write_pc = makePooled<RegWritePCMicroOp>(8);
+    PIMicroOp compute_addr = makePooled<RegAddImmMicroOp>(8, 8, decoded.imm);
+    PIMicroOp store = makePooled<MemWriteRegMicroOp>(8, src_id);
 
     write_pc->insert(compute_addr);
     compute_addr->insert(store);
     return write_pc;
 }
 
-PIMicroOp STIInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp STIInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t src_id = getOperand(1)->getValue();
-    PIMicroOp write_pc = std::make_shared<RegWritePCMicroOp>(8);
-    PIMicroOp compute_addr = std::make_shared<RegAddImmMicroOp>(8, 8,
-        lc3::utils::sextTo16(getOperand(2)->getValue(), getOperand(2)->getWidth()));
-    PIMicroOp load = std::make_shared<MemReadMicroOp>(8, 8);
-    PIMicroOp store = std::make_shared<MemWriteRegMicroOp>(8, src_id);
+    uint16_t src_id = decoded.dr;
+    PIMicroOp write_pc = makePooled<RegWritePCMicroOp>(8);
+    PIMicroOp compute_addr = makePooled<RegAddImmMicroOp>(8, 8, decoded.imm);
+    PIMicroOp load = makePooled<MemReadMicroOp>(8, 8);
+    PIMicroOp store = makePooled<MemWriteRegMicroOp>(8, src_id);
 
     write_pc->insert(compute_addr);
     compute_addr->insert(load);
@@ -332,28 +334,27 @@ PIMicroOp STIInstruction::buildMicroOps(MachineState const & state) const
     return write_pc;
 }
 
-PIMicroOp STRInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp STRInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
     (void) state;
 
-    uint16_t src_id = getOperand(1)->getValue();
-    uint16_t base_id = getOperand(2)->getValue();
-    PIMicroOp write_base = std::make_shared<RegWriteRegMicroOp>(8, base_id);
-    PIMicroOp compute_addr = std::make_shared<RegAddImmMicroOp>(8, 8,
-        lc3::utils::sextTo16(getOperand(3)->getValue(), getOperand(3)->getWidth()));
-    PIMicroOp store = std::make_shared<MemWriteRegMicroOp>(8, src_id);
+    uint16_t src_id = decoded.dr;
+    uint16_t base_id = decoded.sr1;
+    PIMicroOp write_base = makePooled<RegWriteRegMicroOp>(8, base_id);
+    PIMicroOp compute_addr = makePooled<RegAddImmMicroOp>(8, 8, decoded.imm);
+    PIMicroOp store = makePooled<MemWriteRegMicroOp>(8, src_id);
 
     write_base->insert(compute_addr);
     compute_addr->insert(store);
     return write_base;
 }
 
-PIMicroOp TRAPInstruction::buildMicroOps(MachineState const & state) const
+PIMicroOp TRAPInstruction::buildMicroOps(MachineState const & state, sim::DecodedInstruction const & decoded) const
 {
-    std::pair<PIMicroOp, PIMicroOp> handle_trap_chain = buildSystemModeEnter(TRAP_TABLE_START,
-        static_cast<uint8_t>(getOperand(2)->getValue()), (state.readPSR() & 0x0700) >> 8);
-    PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::SUB_ENTER);
-    PIMicroOp func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::TRAP);
+    std::pair<PIMicroOp, PIMicroOp> handle_trap_chain = buildSystemModeEnter(TRAP_TABLE_START, decoded.vec,
+        (state.readPSR() & 0x0700) >> 8);
+    PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::SUB_ENTER);
+    PIMicroOp func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::TRAP);
 
     handle_trap_chain.second->insert(callback);
     callback->insert(func_trace);
@@ -372,27 +373,27 @@ bool lc3::core::isAccessViolation(uint16_t addr, MachineState const & state)
 
 std::pair<PIMicroOp, PIMicroOp> lc3::core::buildSystemModeEnter(uint16_t table_start, uint8_t vec, uint8_t priority)
 {
-    PIMicroOp save_cur_sp = std::make_shared<RegWriteRegMicroOp>(8, 6);
-    PIMicroOp write_ssp = std::make_shared<RegWriteSSPMicroOp>(6);
-    PIMicroOp write_cur_sp = std::make_shared<SSPWriteRegMicroOp>(8);
-    PIMicroOp dec_sp1 = std::make_shared<RegAddImmMicroOp>(6, 6, -1);
-    PIMicroOp write_psr = std::make_shared<RegWritePSRMicroOp>(9);
-    PIMicroOp copy_psr = std::make_shared<RegWriteRegMicroOp>(10, 9);
-    PIMicroOp clear_priority = std::make_shared<RegAndImmMicroOp>(10, 10, 0xF1FF);
-    PIMicroOp set_priority = std::make_shared<RegAddImmMicroOp>(10, 10, (priority & 0x7) << 8);
-    PIMicroOp write_priority = std::make_shared<PSRWriteRegMicroOp>(10);
-    PIMicroOp set_priv = std::make_shared<RegAndImmMicroOp>(10, 10, 0x7FFF);
-    PIMicroOp change_priv = std::make_shared<PSRWriteRegMicroOp>(10);
-    PIMicroOp store_psr = std::make_shared<MemWriteRegMicroOp>(6, 9);
-    PIMicroOp dec_sp2 = std::make_shared<RegAddImmMicroOp>(6, 6, -1);
-    PIMicroOp write_pc = std::make_shared<RegWritePCMicroOp>(9);
-    PIMicroOp store_pc = std::make_shared<MemWriteRegMicroOp>(6, 9);
-    PIMicroOp write_table_start = std::make_shared<RegWriteImmMicroOp>(11, table_start);
-    PIMicroOp add_table_offset = std::make_shared<RegAddImmMicroOp>(11, 11, vec);
-    PIMicroOp load_table = std::make_shared<MemReadMicroOp>(11, 11);
-    PIMicroOp jump = std::make_shared<PCWriteRegMicroOp>(11);
-
-    PIMicroOp start = std::make_shared<BranchMicroOp>([](MachineState const & state) {
+    PIMicroOp save_cur_sp = makePooled<RegWriteRegMicroOp>(8, 6);
+    PIMicroOp write_ssp = makePooled<RegWriteSSPMicroOp>(6);
+    PIMicroOp write_cur_sp = makePooled<SSPWriteRegMicroOp>(8);
+    PIMicroOp dec_sp1 = makePooled<RegAddImmMicroOp>(6, 6, -1);
+    PIMicroOp write_psr = makePooled<RegWritePSRMicroOp>(9);
+    PIMicroOp copy_psr = makePooled<RegWriteRegMicroOp>(10, 9);
+    PIMicroOp clear_priority = makePooled<RegAndImmMicroOp>(10, 10, 0xF1FF);
+    PIMicroOp set_priority = makePooled<RegAddImmMicroOp>(10, 10, (priority & 0x7) << 8);
+    PIMicroOp write_priority = makePooled<PSRWriteRegMicroOp>(10);
+    PIMicroOp set_priv = makePooled<RegAndImmMicroOp>(10, 10, 0x7FFF);
+    PIMicroOp change_priv = makePooled<PSRWriteRegMicroOp>(10);
+    PIMicroOp store_psr = makePooled<MemWriteRegMicroOp>(6, 9);
+    PIMicroOp dec_sp2 = makePooled<RegAddImmMicroOp>(6, 6, -1);
+    PIMicroOp write_pc = makePooled<RegWritePCMicroOp>(9);
+    PIMicroOp store_pc = makePooled<MemWriteRegMicroOp>(6, 9);
+    PIMicroOp write_table_start = makePooled<RegWriteImmMicroOp>(11, table_start);
+    PIMicroOp add_table_offset = makePooled<RegAddImmMicroOp>(11, 11, vec);
+    PIMicroOp load_table = makePooled<MemReadMicroOp>(11, 11);
+    PIMicroOp jump = makePooled<PCWriteRegMicroOp>(11);
+
+    PIMicroOp start = makePooled<BranchMicroOp>([](MachineState const & state) {
         return lc3::utils::getBit(state.readPSR(), 15) == 1;
     }, "PSR[15] == 1", save_cur_sp, dec_sp1);
 
@@ -405,7 +406,7 @@ std::pair<PIMicroOp, PIMicroOp> lc3::core::buildSystemModeEnter(uint16_t table_s
     copy_psr->insert(clear_priority);
     clear_priority->insert(set_priority);
     set_priority->insert(write_priority);
-    write_priority->insert(std::make_shared<BranchMicroOp>([](MachineState const & state) {
+    write_priority->insert(makePooled<BranchMicroOp>([](MachineState const & state) {
         return lc3::utils::getBit(state.readPSR(), 15) == 1;
     }, "PSR[15] == 1", set_priv, store_psr));
 
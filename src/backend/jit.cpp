@@ -0,0 +1,418 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "jit.h"
+
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "device_regs.h"
+
+#ifdef _ENABLE_JIT
+    #include <sys/mman.h>
+#endif
+
+using namespace lc3::core::sim;
+
+static constexpr size_t CODE_BUFFER_SIZE = 1 << 20;
+
+namespace
+{
+    // Emits the x86-64 instructions that translated blocks are built from.  Within a block, r8w-r15w hold R0-R7, cx
+    // holds the last value that set the condition codes, rdi holds the context, rsi holds the address of memory, ebx
+    // counts the instructions executed by earlier passes through the block, and ebp holds the budget.  eax and edx
+    // are scratch.
+    class Emitter
+    {
+    public:
+        std::vector<uint8_t> code;
+
+        Emitter(void) : common_exit(newLabel()) {}
+
+        size_t newLabel(void)
+        {
+            labels.push_back(0);
+            return labels.size() - 1;
+        }
+        void bind(size_t label) { labels[label] = code.size(); }
+
+        // Exits to the simulator with the PC set to pc.  index is both the index of the first instruction that was not
+        // executed and the number of instructions executed in this pass through the block.
+        size_t exitLabel(uint16_t pc, uint32_t index)
+        {
+            auto search = exits.find(std::make_pair(pc, index));
+            if(search != exits.end()) {
+                return search->second;
+            }
+
+            size_t label = newLabel();
+            exits[std::make_pair(pc, index)] = label;
+            return label;
+        }
+
+        void prologue(void)
+        {
+            emit({0x53, 0x55, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57}); // push rbx, rbp, r12-r15
+            emit({0x48, 0x8B, 0x77, offset(offsetof(JITContext, mem))});          // mov rsi, [rdi+mem]
+            emit({0x48, 0x8B, 0x47, offset(offsetof(JITContext, regs))});         // mov rax, [rdi+regs]
+            for(uint8_t reg = 0; reg < 8; reg += 1) {
+                emit({0x44, 0x0F, 0xB7, static_cast<uint8_t>(0x40 | (reg << 3)), static_cast<uint8_t>(reg * 2)});
+            }                                                                       // movzx rNd, word [rax+2n]
+
+            // Condition codes are held as a value that sets them: 0x8000, 0, or 1.
+            emit({0x0F, 0xB7, 0x47, offset(offsetof(JITContext, psr))});          // movzx eax, word [rdi+psr]
+            emit({0xB9, 0x01, 0x00, 0x00, 0x00});                                  // mov ecx, 1
+            emit({0xA8, 0x02, 0x74, 0x02, 0x31, 0xC9});                            // test al, 2; jz +2; xor ecx, ecx
+            emit({0xA8, 0x04, 0x74, 0x05, 0xB9, 0x00, 0x80, 0x00, 0x00});          // test al, 4; jz +5; mov ecx, 8000h
+
+            emit({0x8B, 0x6F, offset(offsetof(JITContext, budget))});             // mov ebp, [rdi+budget]
+            emit({0x31, 0xDB});                                                    // xor ebx, ebx
+        }
+
+        // Exits unless at least count instructions are left in the budget.
+        void checkBudget(uint32_t count, size_t exit)
+        {
+            emit({0x89, 0xE8, 0x29, 0xD8});                                        // mov eax, ebp; sub eax, ebx
+            emit({0x3D}); imm32(count);                                            // cmp eax, count
+            jcc(0x82, exit);                                                       // jb exit
+        }
+
+        void loopBack(uint32_t count, size_t head)
+        {
+            emit({0x81, 0xC3}); imm32(count);                                      // add ebx, count
+            jmp(head);
+        }
+
+        void moveReg(uint8_t dst, uint8_t src)                                     // mov dst, src
+        {
+            if(dst != src) { emit({0x66, 0x45, 0x89, modRM(src, dst)}); }
+        }
+        void addReg(uint8_t dst, uint8_t src) { emit({0x66, 0x45, 0x01, modRM(src, dst)}); }        // add dst, src
+        void andReg(uint8_t dst, uint8_t src) { emit({0x66, 0x45, 0x21, modRM(src, dst)}); }        // and dst, src
+        void addImm(uint8_t dst, uint16_t value) { emit({0x66, 0x41, 0x81, modRM(0, dst)}); imm16(value); }
+        void andImm(uint8_t dst, uint16_t value) { emit({0x66, 0x41, 0x81, modRM(4, dst)}); imm16(value); }
+        void notReg(uint8_t dst) { emit({0x66, 0x41, 0xF7, modRM(2, dst)}); }                       // not dst
+        void moveImm(uint8_t dst, uint16_t value)                                                   // mov dst, value
+        {
+            emit({0x66, 0x41, static_cast<uint8_t>(0xB8 + dst)});
+            imm16(value);
+        }
+        void setCC(uint8_t reg) { emit({0x66, 0x44, 0x89, static_cast<uint8_t>(0xC1 | (reg << 3))}); } // mov cx, reg
+
+        // Branches to label if any of the condition codes in mask are set.
+        void branchCC(uint8_t mask, size_t label)
+        {
+            static uint8_t const conditions[8] = {0, 0x8F, 0x84, 0x89, 0x88, 0x85, 0x8E, 0};
+            if(mask == 0) {
+                return;
+            } else if(mask == 7) {
+                jmp(label);
+                return;
+            }
+
+            emit({0x66, 0x85, 0xC9});                                              // test cx, cx
+            jcc(conditions[mask], label);                                          // js, jz, jg, jle, jne, or jns
+        }
+        void jump(size_t label) { jmp(label); }
+
+        void addressImm(uint16_t addr) { emit({0xBA}); imm32(addr); }             // mov edx, addr
+        void addressReg(uint8_t base, uint16_t offset)                             // movzx edx, base; add dx, offset
+        {
+            emit({0x41, 0x0F, 0xB7, modRM(2, base)});
+            if(offset != 0) {
+                emit({0x66, 0x81, 0xC2});
+                imm16(offset);
+            }
+        }
+        // Exits unless edx is an ordinary memory address that the current privilege allows.
+        void checkAddress(size_t exit)
+        {
+            emit({0x81, 0xFA}); imm32(MMIO_START);                                 // cmp edx, MMIO_START
+            jcc(0x83, exit);                                                       // jae exit
+            emit({0x66, 0x3B, 0x57, offset(offsetof(JITContext, mem_start))});    // cmp dx, [rdi+mem_start]
+            jcc(0x82, exit);                                                       // jb exit
+        }
+        void loadAddress(void) { emit({0x0F, 0xB7, 0x14, 0x56}); }                // movzx edx, word [rsi+rdx*2]
+        void load(uint8_t dst)                                                     // movzx dst, word [rsi+rdx*2]
+        {
+            emit({0x44, 0x0F, 0xB7, static_cast<uint8_t>(0x04 | (dst << 3)), 0x56});
+        }
+        // Exits if edx has been translated into a cached block, and otherwise stores src there and marks its page
+        // dirty.
+        void store(uint8_t src, size_t exit)
+        {
+            emit({0x48, 0x8B, 0x47, offset(offsetof(JITContext, translated_words))}); // mov rax, [rdi+translated]
+            emit({0x48, 0x0F, 0xA3, 0x10});                                            // bt [rax], rdx
+            jcc(0x82, exit);                                                           // jc exit
+            emit({0x66, 0x44, 0x89, static_cast<uint8_t>(0x04 | (src << 3)), 0x56}); // mov [rsi+rdx*2], src
+            emit({0xC1, 0xEA, 0x08});                                                  // shr edx, 8
+            emit({0x48, 0x8B, 0x47, offset(offsetof(JITContext, dirty_pages))});      // mov rax, [rdi+dirty]
+            emit({0x48, 0x0F, 0xAB, 0x10});                                            // bts [rax], rdx
+        }
+
+        // Emits the exits and the code they share, which writes back the registers and condition codes and returns
+        // the number of instructions executed, then resolves every jump.
+        void finish(void)
+        {
+            for(auto const & exit : exits) {
+                bind(exit.second);
+                emit({0x66, 0xC7, 0x47, offset(offsetof(JITContext, pc))});       // mov word [rdi+pc], pc
+                imm16(exit.first.first);
+                emit({0xC7, 0x47, offset(offsetof(JITContext, exit_index))});     // mov dword [rdi+exit_index], index
+                imm32(exit.first.second);
+                emit({0xB8}); imm32(exit.first.second);                            // mov eax, index
+                jmp(common_exit);
+            }
+
+            bind(common_exit);
+            emit({0x01, 0xC3});                                                    // add ebx, eax
+            emit({0x48, 0x8B, 0x47, offset(offsetof(JITContext, regs))});         // mov rax, [rdi+regs]
+            for(uint8_t reg = 0; reg < 8; reg += 1) {
+                emit({0x66, 0x44, 0x89, static_cast<uint8_t>(0x40 | (reg << 3)), static_cast<uint8_t>(reg * 2)});
+            }                                                                       // mov [rax+2n], rNw
+            emit({0xB8, 0x02, 0x00, 0x00, 0x00});                                  // mov eax, 2
+            emit({0x66, 0x85, 0xC9, 0x74, 0x0C});                                  // test cx, cx; jz +12
+            emit({0xB8, 0x04, 0x00, 0x00, 0x00, 0x78, 0x05});                      // mov eax, 4; js +5
+            emit({0xB8, 0x01, 0x00, 0x00, 0x00});                                  // mov eax, 1
+            emit({0x66, 0x81, 0x67, offset(offsetof(JITContext, psr)), 0xF8, 0xFF}); // and word [rdi+psr], 0FFF8h
+            emit({0x66, 0x09, 0x47, offset(offsetof(JITContext, psr))});          // or [rdi+psr], ax
+            emit({0x89, 0xD8});                                                    // mov eax, ebx
+            emit({0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5D, 0x5B});  // pop r15-r12, rbp, rbx
+            emit({0xC3});                                                          // ret
+
+            for(auto const & fixup : fixups) {
+                int32_t rel = static_cast<int32_t>(labels[fixup.second] - (fixup.first + 4));
+                std::memcpy(&code[fixup.first], &rel, sizeof(rel));
+            }
+        }
+
+    private:
+        std::vector<size_t> labels;
+        std::vector<std::pair<size_t, size_t>> fixups;
+        std::map<std::pair<uint16_t, uint32_t>, size_t> exits;
+        size_t common_exit;
+
+        void emit(std::initializer_list<uint8_t> bytes) { code.insert(code.end(), bytes); }
+        void imm16(uint16_t value) { emit({static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)}); }
+        void imm32(uint32_t value) { imm16(value & 0xFFFF); imm16(value >> 16); }
+        void rel32(size_t label)
+        {
+            fixups.emplace_back(code.size(), label);
+            imm32(0);
+        }
+        void jmp(size_t label) { emit({0xE9}); rel32(label); }
+        void jcc(uint8_t condition, size_t label) { emit({0x0F, condition}); rel32(label); }
+
+        // Register-direct operand, where reg is either a register or an opcode extension.
+        static uint8_t modRM(uint8_t reg, uint8_t rm) { return static_cast<uint8_t>(0xC0 | (reg << 3) | rm); }
+        static uint8_t offset(size_t value) { return static_cast<uint8_t>(value); }
+    };
+
+    bool isTranslated(DecodedInstruction const & decoded)
+    {
+        if(decoded.inst == nullptr) {
+            return false;
+        }
+
+        switch(decoded.type) {
+            case InstType::ADD_REG:
+            case InstType::ADD_IMM:
+            case InstType::AND_REG:
+            case InstType::AND_IMM:
+            case InstType::BR:
+            case InstType::LD:
+            case InstType::LDI:
+            case InstType::LDR:
+            case InstType::LEA:
+            case InstType::NOT:
+            case InstType::ST:
+            case InstType::STI:
+            case InstType::STR:
+                return true;
+
+            default:
+                return false;
+        }
+    }
+};
+
+JIT::JIT(void) : buffer(nullptr), capacity(0), used(0), epoch(1) {}
+
+JIT::~JIT(void)
+{
+#ifdef _ENABLE_JIT
+    if(buffer != nullptr) {
+        munmap(buffer, capacity);
+    }
+#endif
+}
+
+bool JIT::isSupported(void)
+{
+#ifdef _ENABLE_JIT
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool JIT::compile(BasicBlock & block)
+{
+    if(block.native_epoch == epoch) {
+        return true;
+    }
+    block.native_epoch = epoch;
+    block.native_code = nullptr;
+
+#ifdef _ENABLE_JIT
+    uint32_t count = 0;
+    while(count < block.length && isTranslated(*block.insts[count])) {
+        count += 1;
+    }
+    if(count == 0) {
+        return true;
+    }
+
+    Emitter out;
+    out.prologue();
+
+    size_t head = out.newLabel();
+    out.bind(head);
+    out.checkBudget(count, out.exitLabel(block.start_pc, 0));
+
+    for(uint32_t i = 0; i < count; i += 1) {
+        DecodedInstruction const & decoded = *block.insts[i];
+        uint16_t next_pc = block.start_pc + i + 1;
+
+        switch(decoded.type) {
+            case InstType::ADD_REG:
+            case InstType::AND_REG: {
+                uint8_t other = decoded.sr2;
+                if(decoded.dr == decoded.sr2) {
+                    other = decoded.sr1;
+                } else {
+                    out.moveReg(decoded.dr, decoded.sr1);
+                }
+                if(decoded.type == InstType::ADD_REG) { out.addReg(decoded.dr, other); }
+                else { out.andReg(decoded.dr, other); }
+                out.setCC(decoded.dr);
+                break;
+            }
+
+            case InstType::ADD_IMM:
+            case InstType::AND_IMM:
+            case InstType::NOT:
+                out.moveReg(decoded.dr, decoded.sr1);
+                if(decoded.type == InstType::ADD_IMM) { out.addImm(decoded.dr, decoded.imm); }
+                else if(decoded.type == InstType::AND_IMM) { out.andImm(decoded.dr, decoded.imm); }
+                else { out.notReg(decoded.dr); }
+                out.setCC(decoded.dr);
+                break;
+
+            case InstType::LEA:
+                out.moveImm(decoded.dr, next_pc + decoded.imm);
+                break;
+
+            case InstType::BR: {
+                // A branch always ends the block.  Branching back to the start of the block loops natively.
+                uint16_t targets[2] = { static_cast<uint16_t>(next_pc + decoded.imm), next_pc };
+                size_t labels[2];
+                for(uint32_t j = 0; j < 2; j += 1) {
+                    labels[j] = targets[j] == block.start_pc ? out.newLabel() : out.exitLabel(targets[j], count);
+                }
+                out.branchCC(decoded.cc, labels[0]);
+                out.jump(labels[1]);
+                for(uint32_t j = 0; j < 2; j += 1) {
+                    if(targets[j] == block.start_pc) {
+                        out.bind(labels[j]);
+                        out.loopBack(count, head);
+                    }
+                }
+                break;
+            }
+
+            case InstType::LD:
+            case InstType::LDI:
+            case InstType::LDR: {
+                size_t side_exit = out.exitLabel(block.start_pc + i, i);
+                if(decoded.type == InstType::LDR) { out.addressReg(decoded.sr1, decoded.imm); }
+                else { out.addressImm(next_pc + decoded.imm); }
+                out.checkAddress(side_exit);
+                if(decoded.type == InstType::LDI) {
+                    out.loadAddress();
+                    out.checkAddress(side_exit);
+                }
+                out.load(decoded.dr);
+                out.setCC(decoded.dr);
+                break;
+            }
+
+            case InstType::ST:
+            case InstType::STI:
+            case InstType::STR: {
+                size_t side_exit = out.exitLabel(block.start_pc + i, i);
+                if(decoded.type == InstType::STR) { out.addressReg(decoded.sr1, decoded.imm); }
+                else { out.addressImm(next_pc + decoded.imm); }
+                out.checkAddress(side_exit);
+                if(decoded.type == InstType::STI) {
+                    out.loadAddress();
+                    out.checkAddress(side_exit);
+                }
+                out.store(decoded.dr, side_exit);
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+
+    if(block.insts[count - 1]->type != InstType::BR) {
+        out.jump(out.exitLabel(block.start_pc + count, count));
+    }
+
+    out.finish();
+
+    if(out.code.size() > CODE_BUFFER_SIZE) {
+        return true;
+    }
+
+    // The buffer is only writable while code is being copied into it, and only executable otherwise.
+    if(buffer == nullptr) {
+        void * mapped = mmap(nullptr, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if(mapped == MAP_FAILED) {
+            return false;
+        }
+        buffer = static_cast<uint8_t *>(mapped);
+        capacity = CODE_BUFFER_SIZE;
+    } else if(mprotect(buffer, capacity, PROT_READ | PROT_WRITE) != 0) {
+        return false;
+    }
+
+    if(used + out.code.size() > capacity) {
+        // Rather than tracking which blocks are still live, throw everything away and let hot blocks recompile.
+        reset();
+        block.native_epoch = epoch;
+    }
+
+    std::memcpy(buffer + used, out.code.data(), out.code.size());
+    if(mprotect(buffer, capacity, PROT_READ | PROT_EXEC) != 0) {
+        // None of the compiled blocks can be run, so they are all discarded.
+        reset();
+        return false;
+    }
+
+    block.native_code = buffer + used;
+    used += out.code.size();
+#endif
+    return true;
+}
+
+void JIT::reset(void)
+{
+    used = 0;
+    epoch += 1;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef JIT_H
+#define JIT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "block_cache.h"
+
+#if defined(LC3_ENABLE_JIT) && defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+    #define _ENABLE_JIT
+#endif
+
+namespace lc3
+{
+namespace core
+{
+namespace sim
+{
+    // Shared between the simulator and translated code.  The simulator fills in everything but exit_index before
+    // running a block, and translated code writes back pc, psr, and exit_index (the index in the block of the first
+    // instruction that was not executed) before it returns the number of instructions it executed.
+    struct JITContext
+    {
+        uint16_t * regs;
+        uint16_t * mem;
+        uint64_t const * translated_words;
+        uint64_t * dirty_pages;
+        // Number of instructions that may be executed before returning to the simulator.
+        uint32_t budget;
+        uint32_t exit_index;
+        uint16_t pc;
+        uint16_t psr;
+        // Loads and stores below this address (or to device registers) are left to the interpreter.
+        uint16_t mem_start;
+    };
+
+    // Translates basic blocks into x86-64 machine code.  Within a block the LC-3 registers and condition codes are
+    // held in host registers, and ALU instructions, LEA, BR, and loads and stores to ordinary memory run natively.
+    // A block that branches back to its own start keeps looping natively until its budget runs out.  Translated code
+    // returns to the simulator before any instruction that it cannot execute on its own: one that accesses a device
+    // register or an address the current privilege does not allow, stores to a word that has been translated, or
+    // transfers control through a subroutine, trap, or interrupt.  The simulator only runs translated code when no
+    // device, interrupt, breakpoint, watchpoint, or callback needs to see the individual instructions, so everything
+    // else happens at block exits.  The code buffer is never writable and executable at the same time.  On other
+    // hosts, or when the JIT is not enabled in the build, compile() never produces code and every block is
+    // interpreted.
+    class JIT
+    {
+    public:
+        using BlockFunc = uint32_t (*)(JITContext * ctx);
+
+        static constexpr uint32_t DEFAULT_THRESHOLD = 64;
+
+        JIT(void);
+        ~JIT(void);
+        JIT(JIT const &) = delete;
+        JIT & operator=(JIT const &) = delete;
+
+        static bool isSupported(void);
+
+        // Compiles the block, unless it has already been compiled (or found to have nothing worth compiling) since
+        // the buffer was last reset.  Returns false if the code buffer cannot be used at all.
+        bool compile(BasicBlock & block);
+        bool isCompiled(BasicBlock const & block) const {
+            return block.native_code != nullptr && block.native_epoch == epoch;
+        }
+        uint32_t run(BasicBlock const & block, JITContext * ctx) const {
+            return reinterpret_cast<BlockFunc>(const_cast<void *>(block.native_code))(ctx);
+        }
+
+    private:
+        uint8_t * buffer;
+        size_t capacity;
+        size_t used;
+        uint32_t epoch;
+
+        void reset(void);
+    };
+};
+};
+};
+
+#endif
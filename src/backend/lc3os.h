@@ -4,6 +4,7 @@
 #ifndef LC3OS_H
 #define LC3OS_H
 
+#include <cstdint>
 #include <string>
 
 namespace lc3
@@ -11,6 +12,29 @@ namespace lc3
 namespace core
 {
     std::string getOSSrc(void);
+
+    // A contiguous run of words starting at orig, taken from offset in the image's word (and line) arrays.
+    struct MemImageSegment
+    {
+        uint16_t orig;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    // Assembled memory contents that can be copied straight into memory, without going through an object file.  lines
+    // is parallel to words and may be null if source lines were not kept.
+    struct MemImage
+    {
+        MemImageSegment const * segments;
+        uint32_t num_segments;
+        uint16_t const * words;
+        char const * const * lines;
+    };
+
+#ifdef LC3_PRECOMPILED_OS
+    // The OS, assembled from getOSSrc at build time.  Defined in a source file generated by lc3os_gen.
+    MemImage const & getOSImage(void);
+#endif
 };
 };
 
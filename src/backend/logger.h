@@ -10,6 +10,12 @@
 #include "printer.h"
 #include "utils.h"
 
+// Messages above LC3_TRACE_LEVEL are compiled out: isEnabled is a constant false for them, so any trace site guarded by
+// it is removed along with its formatting.  By default, every level is compiled in.
+#ifndef LC3_TRACE_LEVEL
+    #define LC3_TRACE_LEVEL 9
+#endif
+
 namespace lc3
 {
 namespace utils
@@ -28,7 +34,11 @@ namespace utils
         template<typename ... Args>
         void printf(PrintType level, bool bold, std::string const & format, Args ... args) const;
         void newline(PrintType level = PrintType::P_ERROR) const {
-            if(print_level > static_cast<uint32_t>(level)) { printer.newline(); }
+            if(isEnabled(level) && print_level > static_cast<uint32_t>(level)) { printer.newline(); }
+        }
+        // Cheap enough to call before doing any work to build a message.
+        bool isEnabled(PrintType level) const {
+            return static_cast<uint32_t>(level) <= LC3_TRACE_LEVEL && static_cast<uint32_t>(level) <= print_level;
         }
         void print(std::string const & str) {
             if(print_level > static_cast<uint32_t>(PrintType::P_NONE)) { printer.print(str); }
@@ -69,7 +79,7 @@ void lc3::utils::Logger::printf(lc3::utils::PrintType type, bool bold, std::stri
     lc3::utils::PrintColor color = lc3::utils::PrintColor::RESET;
     std::string label = "";
 
-    if(static_cast<uint32_t>(type) <= print_level) {
+    if(isEnabled(type)) {
         switch(type) {
             case PrintType::P_ERROR:
                 color = lc3::utils::PrintColor::RED;
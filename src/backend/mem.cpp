@@ -38,15 +38,19 @@ std::ostream & lc3::core::operator<<(std::ostream & out, lc3::core::MemLocation
 std::istream & lc3::core::operator>>(std::istream & in, MemLocation & out)
 {
     uint16_t value;
-    bool is_orig;
+    uint8_t is_orig;
+    uint32_t num_chars;
 
+    // Callers read until the end of the stream, so the last read comes up short.  out is left untouched in that case
+    // rather than being filled in with whatever was on the stack.
     in.read(reinterpret_cast<char *>(&value), 2);
     in.read(reinterpret_cast<char *>(&is_orig), 1);
-    out.value = value;
-    out.is_orig = is_orig;
-
-    uint32_t num_chars;
     in.read(reinterpret_cast<char *>(&num_chars), 4);
+    if(! in) {
+        return in;
+    }
+    out.value = value;
+    out.is_orig = is_orig != 0;
 #ifdef _ENABLE_DEBUG_ASM
     std::cout << "value: " << lc3::utils::ssprintf("0x%04x", out.value) << "\n";
     std::cout << "orig: " << out.is_orig << "\n";
@@ -65,3 +69,38 @@ std::istream & lc3::core::operator>>(std::istream & in, MemLocation & out)
 
     return in;
 }
+
+std::string const & lc3::core::MemLineTable::getLine(uint16_t addr) const
+{
+    static std::string const empty;
+
+    auto search = line_ids.find(addr);
+    if(search == line_ids.end()) {
+        return empty;
+    }
+
+    return lines[search->second];
+}
+
+void lc3::core::MemLineTable::setLine(uint16_t addr, std::string const & line)
+{
+    if(line.empty()) {
+        line_ids.erase(addr);
+        return;
+    }
+
+    auto search = interned.find(line);
+    if(search == interned.end()) {
+        search = interned.emplace(line, static_cast<uint32_t>(lines.size())).first;
+        lines.push_back(line);
+    }
+
+    line_ids[addr] = search->second;
+}
+
+void lc3::core::MemLineTable::clear(void)
+{
+    line_ids.clear();
+    lines.clear();
+    interned.clear();
+}
@@ -4,8 +4,11 @@
 #ifndef MEM_NEW_H
 #define MEM_NEW_H
 
+#include <cstdint>
 #include <string>
 #include <iostream>
+#include <unordered_map>
+#include <vector>
 
 namespace lc3
 {
@@ -37,6 +40,22 @@ namespace core
 
     std::ostream & operator<<(std::ostream & out, MemLocation const & in);
     std::istream & operator>>(std::istream & in, MemLocation & out);
+
+    // Sparse map from address to the source line it was assembled from, which is only needed by the debugger and
+    // GUI.  Most addresses have no line, and the same lines are set over and over (e.g. whenever the OS is reloaded),
+    // so each distinct line is only stored once.
+    class MemLineTable
+    {
+    public:
+        std::string const & getLine(uint16_t addr) const;
+        void setLine(uint16_t addr, std::string const & line);
+        void clear(void);
+
+    private:
+        std::unordered_map<uint16_t, uint32_t> line_ids;
+        std::vector<std::string> lines;
+        std::unordered_map<std::string, uint32_t> interned;
+    };
 };
 };
 
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "pool.h"
+
+#include <new>
+
+using namespace lc3::core;
+
+static constexpr std::size_t SIZE_GRANULARITY = 16;
+static constexpr std::size_t NUM_SIZE_CLASSES = 16;
+static constexpr std::size_t CHUNK_SIZE = 1 << 14;
+
+namespace
+{
+    struct FreeBlock
+    {
+        FreeBlock * next;
+    };
+
+    // Plain data, so that it needs no destructor and can still be used while other thread-local and static objects
+    // are being destroyed.  Blocks left on a list when a thread exits are not reclaimed.
+    thread_local FreeBlock * free_lists[NUM_SIZE_CLASSES];
+
+    std::size_t getSizeClass(std::size_t size)
+    {
+        return (size + SIZE_GRANULARITY - 1) / SIZE_GRANULARITY - 1;
+    }
+
+    void refill(std::size_t size_class)
+    {
+        std::size_t block_size = (size_class + 1) * SIZE_GRANULARITY;
+        char * chunk = static_cast<char *>(::operator new(CHUNK_SIZE));
+
+        FreeBlock * head = free_lists[size_class];
+        for(std::size_t offset = 0; offset + block_size <= CHUNK_SIZE; offset += block_size) {
+            FreeBlock * block = reinterpret_cast<FreeBlock *>(chunk + offset);
+            block->next = head;
+            head = block;
+        }
+        free_lists[size_class] = head;
+    }
+};
+
+void * PoolAllocator::allocate(std::size_t size)
+{
+    std::size_t size_class = getSizeClass(size);
+    if(size_class >= NUM_SIZE_CLASSES) {
+        return ::operator new(size);
+    }
+
+    if(free_lists[size_class] == nullptr) {
+        refill(size_class);
+    }
+
+    FreeBlock * block = free_lists[size_class];
+    free_lists[size_class] = block->next;
+    return block;
+}
+
+void PoolAllocator::deallocate(void * ptr, std::size_t size)
+{
+    if(ptr == nullptr) {
+        return;
+    }
+
+    std::size_t size_class = getSizeClass(size);
+    if(size_class >= NUM_SIZE_CLASSES) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    FreeBlock * block = static_cast<FreeBlock *>(ptr);
+    block->next = free_lists[size_class];
+    free_lists[size_class] = block;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace lc3
+{
+namespace core
+{
+    // Allocator for the small, short-lived objects (micro-ops and events) that the detailed engine creates for every
+    // instruction.  Freed blocks are kept on per-thread free lists, segregated by size, and reused by the next
+    // allocation of the same size, so once a simulation reaches a steady state it no longer touches the heap.  Memory
+    // is never returned to the system.
+    class PoolAllocator
+    {
+    public:
+        static void * allocate(std::size_t size);
+        static void deallocate(void * ptr, std::size_t size);
+    };
+
+    // Base class for pool-allocated objects that are owned through an IntrusivePtr.  The reference count is not
+    // atomic; an object must only be shared within a single thread.
+    class PooledObject
+    {
+    public:
+        PooledObject(void) : ref_count(0) { }
+        PooledObject(PooledObject const &) : ref_count(0) { }
+        PooledObject & operator=(PooledObject const &) { return *this; }
+        virtual ~PooledObject(void) = default;
+
+        void addRef(void) const { ++ref_count; }
+        void release(void) const { if(--ref_count == 0) { delete this; } }
+
+        static void * operator new(std::size_t size) { return PoolAllocator::allocate(size); }
+        static void operator delete(void * ptr, std::size_t size) { PoolAllocator::deallocate(ptr, size); }
+
+    private:
+        mutable uint32_t ref_count;
+    };
+
+    template<typename T>
+    class IntrusivePtr
+    {
+    public:
+        IntrusivePtr(void) : ptr(nullptr) { }
+        IntrusivePtr(std::nullptr_t) : ptr(nullptr) { }
+        explicit IntrusivePtr(T * ptr) : ptr(ptr) { if(ptr != nullptr) { ptr->addRef(); } }
+        IntrusivePtr(IntrusivePtr const & other) : IntrusivePtr(other.ptr) { }
+        IntrusivePtr(IntrusivePtr && other) : ptr(other.ptr) { other.ptr = nullptr; }
+        template<typename U>
+        IntrusivePtr(IntrusivePtr<U> const & other) : IntrusivePtr(other.get()) { }
+        ~IntrusivePtr(void) { if(ptr != nullptr) { ptr->release(); } }
+
+        IntrusivePtr & operator=(IntrusivePtr other)
+        {
+            std::swap(ptr, other.ptr);
+            return *this;
+        }
+
+        T * get(void) const { return ptr; }
+        T & operator*(void) const { return *ptr; }
+        T * operator->(void) const { return ptr; }
+        explicit operator bool(void) const { return ptr != nullptr; }
+
+        friend bool operator==(IntrusivePtr const & lhs, std::nullptr_t) { return lhs.ptr == nullptr; }
+        friend bool operator!=(IntrusivePtr const & lhs, std::nullptr_t) { return lhs.ptr != nullptr; }
+        friend bool operator==(IntrusivePtr const & lhs, IntrusivePtr const & rhs) { return lhs.ptr == rhs.ptr; }
+        friend bool operator!=(IntrusivePtr const & lhs, IntrusivePtr const & rhs) { return lhs.ptr != rhs.ptr; }
+
+    private:
+        T * ptr;
+    };
+
+    template<typename T, typename... Args>
+    IntrusivePtr<T> makePooled(Args &&... args)
+    {
+        return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+    }
+};
+};
+
+#endif
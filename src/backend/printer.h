@@ -44,6 +44,14 @@ namespace utils
         virtual void print(std::string const & string) = 0;
         virtual void newline(void) = 0;
     };
+
+    class NullPrinter : public IPrinter
+    {
+    public:
+        virtual void setColor(PrintColor) override {}
+        virtual void print(std::string const &) override {}
+        virtual void newline(void) override {}
+    };
 };
 };
 
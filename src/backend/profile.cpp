@@ -0,0 +1,200 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "profile.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+using namespace lc3::core;
+
+Profile::Profile(void) : pcs(1 << 16), branches_taken(1 << 16), branches_not_taken(1 << 16), hidden_depth(0)
+{
+    opcodes.fill(0);
+    traps.fill(0);
+    call_nodes.push_back(CallNode{TOP_LEVEL, 0, 0, 0, 0, {}});
+    call_stack.push_back(0);
+}
+
+void Profile::enterRoutine(uint16_t routine)
+{
+    if(hidden_depth != 0 || call_stack.size() > MAX_CALL_DEPTH) {
+        hidden_depth += 1;
+        return;
+    }
+
+    uint32_t parent = call_stack.back();
+    auto search = call_nodes[parent].children.find(routine);
+    if(search != call_nodes[parent].children.end()) {
+        call_nodes[search->second].calls += 1;
+        call_stack.push_back(search->second);
+    } else if(call_nodes.size() < MAX_CALL_NODES) {
+        uint32_t node = static_cast<uint32_t>(call_nodes.size());
+        call_nodes[parent].children[routine] = node;
+        call_nodes.push_back(CallNode{routine, parent, call_nodes[parent].depth + 1, 1, 0, {}});
+        call_stack.push_back(node);
+    } else {
+        call_stack.push_back(parent);
+    }
+}
+
+void Profile::exitRoutine(void)
+{
+    // Returns from routines entered before profiling began are ignored.
+    if(hidden_depth != 0) {
+        hidden_depth -= 1;
+    } else if(call_stack.size() > 1) {
+        call_stack.pop_back();
+    }
+}
+
+void Profile::clear(void)
+{
+    Profile cleared;
+    for(std::size_t i = 1; i < call_stack.size(); i += 1) {
+        cleared.enterRoutine(static_cast<uint16_t>(call_nodes[call_stack[i]].routine));
+    }
+    for(CallNode & node : cleared.call_nodes) {
+        node.calls = 0;
+    }
+    cleared.hidden_depth = hidden_depth;
+    *this = std::move(cleared);
+}
+
+uint64_t Profile::getInstCount(void) const
+{
+    uint64_t count = 0;
+    for(uint64_t opcode_count : opcodes) {
+        count += opcode_count;
+    }
+    return count;
+}
+
+std::vector<uint64_t> Profile::getSubtreeInsts(void) const
+{
+    // Children always come after their parents, so a single backwards pass totals every subtree.
+    std::vector<uint64_t> totals(call_nodes.size());
+    for(std::size_t i = call_nodes.size(); i-- > 0;) {
+        totals[i] += call_nodes[i].insts;
+        if(i != 0) {
+            totals[call_nodes[i].parent] += totals[i];
+        }
+    }
+    return totals;
+}
+
+void Profile::walkCallNodes(std::function<void(uint32_t, bool)> const & visit) const
+{
+    // The tree can be as deep as MAX_CALL_DEPTH, so it is walked with an explicit stack.
+    using ChildIter = std::map<uint32_t, uint32_t>::const_iterator;
+    std::vector<std::pair<uint32_t, ChildIter>> stack;
+    visit(0, true);
+    stack.emplace_back(0, call_nodes[0].children.begin());
+    while(! stack.empty()) {
+        uint32_t node = stack.back().first;
+        ChildIter & child = stack.back().second;
+        if(child != call_nodes[node].children.end()) {
+            uint32_t next = child->second;
+            ++child;
+            visit(next, true);
+            stack.emplace_back(next, call_nodes[next].children.begin());
+        } else {
+            visit(node, false);
+            stack.pop_back();
+        }
+    }
+}
+
+std::vector<RoutineStats> Profile::getRoutineStats(void) const
+{
+    std::vector<uint64_t> totals = getSubtreeInsts();
+    std::map<uint32_t, RoutineStats> stats;
+    // Recursive calls are already included in the subtree of the outermost active call.
+    std::map<uint32_t, uint32_t> active;
+    walkCallNodes([this, &totals, &stats, &active](uint32_t index, bool enter) {
+        CallNode const & node = call_nodes[index];
+        if(index == 0) {
+            return;
+        }
+        if(! enter) {
+            active[node.routine] -= 1;
+            return;
+        }
+
+        auto search = stats.find(node.routine);
+        if(search == stats.end()) {
+            search = stats.emplace(node.routine, RoutineStats{node.routine, 0, 0, 0, 0}).first;
+        }
+        RoutineStats & routine = search->second;
+        routine.calls += node.calls;
+        routine.exclusive += node.insts;
+        routine.max_depth = std::max(routine.max_depth, node.depth);
+        if(active[node.routine]++ == 0) {
+            routine.inclusive += totals[index];
+        }
+    });
+
+    std::vector<RoutineStats> ret;
+    for(auto const & entry : stats) {
+        ret.push_back(entry.second);
+    }
+    return ret;
+}
+
+std::vector<CallEdgeStats> Profile::getCallEdgeStats(void) const
+{
+    std::vector<uint64_t> totals = getSubtreeInsts();
+    std::map<std::pair<uint32_t, uint32_t>, CallEdgeStats> stats;
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> active;
+    walkCallNodes([this, &totals, &stats, &active](uint32_t index, bool enter) {
+        CallNode const & node = call_nodes[index];
+        if(index == 0) {
+            return;
+        }
+        uint32_t caller = call_nodes[node.parent].routine;
+        auto key = std::make_pair(caller, node.routine);
+        if(! enter) {
+            active[key] -= 1;
+            return;
+        }
+
+        auto search = stats.find(key);
+        if(search == stats.end()) {
+            search = stats.emplace(key, CallEdgeStats{caller, node.routine, 0, 0}).first;
+        }
+        CallEdgeStats & edge = search->second;
+        edge.calls += node.calls;
+        if(active[key]++ == 0) {
+            edge.inclusive += totals[index];
+        }
+    });
+
+    std::vector<CallEdgeStats> ret;
+    for(auto const & entry : stats) {
+        ret.push_back(entry.second);
+    }
+    return ret;
+}
+
+std::string Profile::getFoldedStacks(std::function<std::string(uint32_t)> const & name) const
+{
+    std::stringstream out;
+    std::string path;
+    std::vector<std::size_t> path_lengths;
+    walkCallNodes([this, &name, &out, &path, &path_lengths](uint32_t index, bool enter) {
+        CallNode const & node = call_nodes[index];
+        if(! enter) {
+            path.resize(path_lengths.back());
+            path_lengths.pop_back();
+            return;
+        }
+
+        path_lengths.push_back(path.size());
+        path += (index == 0 ? "" : ";") + name(node.routine);
+        if(node.insts != 0) {
+            out << path << " " << node.insts << "\n";
+        }
+    });
+    return out.str();
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lc3
+{
+namespace core
+{
+    // Stands in for the routine address of the top level, i.e. whatever was running when profiling began.
+    static constexpr uint32_t TOP_LEVEL = 1 << 16;
+
+    // A node in the calling context tree.  There is one for every distinct chain of calls from the top level, so the
+    // same routine has a node for every place it is called from.
+    struct CallNode
+    {
+        // Address of the first instruction of the routine, or TOP_LEVEL.
+        uint32_t routine;
+        uint32_t parent;
+        uint32_t depth;
+        uint64_t calls;
+        // Instructions executed while this was the innermost routine.
+        uint64_t insts;
+        std::map<uint32_t, uint32_t> children;
+    };
+
+    // Totals for a subroutine, trap, or service routine over every place it was called from.  Instructions executed in
+    // a recursive call are only counted once in the inclusive count.
+    struct RoutineStats
+    {
+        uint32_t routine;
+        uint64_t calls;
+        uint64_t exclusive;
+        uint64_t inclusive;
+        // The most routines that were active, this one included, when it was entered.
+        uint32_t max_depth;
+    };
+
+    // Totals for the calls from one routine to another.
+    struct CallEdgeStats
+    {
+        uint32_t caller;
+        uint32_t callee;
+        uint64_t calls;
+        uint64_t inclusive;
+    };
+
+    // Execution counts gathered while profiling is enabled.  Instructions are counted as they are fetched, by every
+    // engine, so an instruction that raises an exception is still counted but a fetch that is itself an access
+    // violation is not.
+    struct Profile
+    {
+        // Beyond these limits, calls are attributed to the routine that made them, so that a program that calls
+        // without returning cannot use up memory.
+        static constexpr uint32_t MAX_CALL_NODES = 1 << 16;
+        static constexpr uint32_t MAX_CALL_DEPTH = 1 << 12;
+
+        // Indexed by opcode (bits [15:12] of the instruction).
+        std::array<uint64_t, 16> opcodes;
+        // Indexed by the address the instruction was fetched from.
+        std::vector<uint64_t> pcs;
+        // BR instructions, indexed by address.
+        std::vector<uint64_t> branches_taken;
+        std::vector<uint64_t> branches_not_taken;
+        // Indexed by trap vector.
+        std::array<uint64_t, 256> traps;
+        // Keyed by the address of the first instruction of the service routine.
+        std::map<uint16_t, uint64_t> interrupts;
+        std::map<uint16_t, uint64_t> exceptions;
+
+        // The calling context tree, with the top level at index 0.  Parents always come before their children.
+        std::vector<CallNode> call_nodes;
+
+        Profile(void);
+
+        // The condition codes are unchanged by BR, so whether it is taken is known as soon as it is fetched.
+        void recordFetch(uint16_t pc, uint16_t ir, uint16_t psr)
+        {
+            uint16_t opcode = ir >> 12;
+            opcodes[opcode] += 1;
+            pcs[pc] += 1;
+            call_nodes[call_stack.back()].insts += 1;
+            if(opcode == 0x0) {
+                if(((ir >> 9) & psr & 0x7) != 0) {
+                    branches_taken[pc] += 1;
+                } else {
+                    branches_not_taken[pc] += 1;
+                }
+            } else if(opcode == 0xF) {
+                traps[ir & 0xFF] += 1;
+            }
+        }
+
+        // Called once a subroutine, trap, or service routine has been entered, with the address of its first
+        // instruction, and once it has returned.
+        void enterRoutine(uint16_t routine);
+        void exitRoutine(void);
+        // Resets every count.  The routines that are still active are kept, so that their returns are matched.
+        void clear(void);
+
+        uint64_t getInstCount(void) const;
+        std::vector<RoutineStats> getRoutineStats(void) const;
+        std::vector<CallEdgeStats> getCallEdgeStats(void) const;
+        // One line per call chain that executed instructions, in the folded format read by flame graph tools: the
+        // names of the routines from the top level down, separated by semicolons, then the number of instructions.
+        std::string getFoldedStacks(std::function<std::string(uint32_t)> const & name) const;
+
+    private:
+        // The node of every active routine, starting with the top level.  Calls beyond MAX_CALL_DEPTH are only
+        // counted in hidden_depth.
+        std::vector<uint32_t> call_stack;
+        uint64_t hidden_depth;
+
+        std::vector<uint64_t> getSubtreeInsts(void) const;
+        // Calls visit with true when a node is reached and false once all of its descendants have been visited.
+        void walkCallNodes(std::function<void(uint32_t, bool)> const & visit) const;
+    };
+};
+};
+
+#endif
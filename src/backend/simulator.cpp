@@ -5,16 +5,21 @@
 
 #include <algorithm>
 #include <iostream>
+#include <limits>
 
 #include "decoder.h"
 #include "device_regs.h"
+#include "uop.h"
 
 using namespace lc3::core;
 
 static constexpr uint64_t INST_TIMESTEP = 20;
 
 Simulator::Simulator(lc3::utils::IPrinter & printer, lc3::utils::IInputter & inputter, uint32_t print_level) :
-    time(0), logger(printer, print_level)
+    time(0), logger(printer, print_level), callback_mask(0), inst_count(0), pre_inst_pc(0), profiling(false),
+    run_depth(0), encountered_exception(false), engine_type(EngineType::AUTO), inst_callbacks_active(false),
+    fast_engine_active(false), suspend_requested(false), jit_threshold(sim::JIT::DEFAULT_THRESHOLD), jit_verify(false),
+    jit_verify_failures(0)
 {
     devices.emplace_back(std::make_shared<KeyboardDevice>(inputter));
     devices.emplace_back(std::make_shared<DisplayDevice>(logger));
@@ -32,22 +37,24 @@ void Simulator::simulate(void)
 {
     powerOn(0);
     inst_count_this_run = 0;
+    run_depth = stop_conditions.depth;
+    encountered_exception = false;
     async_interrupt = false;
-
-    sim::Decoder decoder;
+    state.clearWatchpointHits();
 
     // Initialize devices.
     for(PIDevice dev : devices) {
         dev->startup();
     }
 
-    do {
-        handleDevices();
-        handleInstruction(decoder);
-    } while(lc3::utils::getBit(state.readMCR(), 15) == 1 && ! async_interrupt);
-    // While this loop is running, async_interrupt will only be read by this thread.  It may be written by another
+    // While the engine is running, async_interrupt will only be read by this thread.  It may be written by another
     // thread, such as in the context of a GUI running the simulator asynchronously, but even then there will only
     // by a single writer and a single reader.  Thus, async_interrupt is left unprotected by mutexes.
+    if(useFastEngine()) {
+        runFastEngine();
+    } else {
+        runDetailedEngine();
+    }
 
     async_interrupt = false;
 
@@ -59,7 +66,15 @@ void Simulator::simulate(void)
 
 void Simulator::loadObj(std::string const & name, std::istream & buffer)
 {
-    events.emplace(std::make_shared<LoadObjFileEvent>(time + 1, name, buffer, logger));
+    events.push(makePooled<LoadObjFileEvent>(time + 1, name, buffer, logger));
+    setup(2);
+
+    executeEvents();
+}
+
+void Simulator::loadImage(std::string const & name, MemImage const & image)
+{
+    events.push(makePooled<LoadImageEvent>(time + 1, name, image, logger));
     setup(2);
 
     executeEvents();
@@ -67,7 +82,7 @@ void Simulator::loadObj(std::string const & name, std::istream & buffer)
 
 void Simulator::setup(uint64_t t_delta)
 {
-    events.emplace(std::make_shared<SetupEvent>(time + t_delta));
+    events.push(makePooled<SetupEvent>(time + t_delta));
     executeEvents();
 }
 
@@ -76,54 +91,125 @@ void Simulator::reinitialize(void)
     state.reinitialize();
 }
 
+PSnapshot Simulator::saveSnapshot(void)
+{
+    std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+    state.saveSnapshot(snapshot->state);
+    for(PIDevice const & dev : devices) {
+        snapshot->devices.push_back(dev->saveState());
+    }
+    snapshot->time = time;
+    snapshot->pre_inst_pc = pre_inst_pc;
+    snapshot->call_stack = call_stack;
+    return snapshot;
+}
+
+void Simulator::restoreSnapshot(PSnapshot const & snapshot)
+{
+    state.restoreSnapshot(snapshot->state);
+    for(size_t i = 0; i < devices.size() && i < snapshot->devices.size(); i += 1) {
+        devices[i]->restoreState(snapshot->devices[i]);
+    }
+    time = snapshot->time;
+    events.reset(time);
+    pre_inst_pc = snapshot->pre_inst_pc;
+    call_stack = snapshot->call_stack;
+}
+
 void Simulator::triggerSuspend()
 {
-    while(! events.empty()) { events.pop(); }
-    events.emplace(std::make_shared<ShutdownEvent>(time));
+    if(fast_engine_active) {
+        // There is no event queue to flush, so drop the remaining callbacks for this phase and shut down directly.
+        suspend_requested = true;
+        state.writeMCR(state.readMCR() & 0x7FFF);
+        return;
+    }
+
+    events.clear();
+    events.push(makePooled<ShutdownEvent>(time));
 }
 
 void Simulator::registerCallback(CallbackType type, Callback func)
 {
-    callbacks[type] = func;
+    uint32_t index = callbackTypeToIndex(type);
+    if(index >= NUM_CALLBACK_TYPES) {
+        return;
+    }
+
+    callbacks[index] = func;
+    if(func != nullptr) {
+        callback_mask |= 1u << index;
+    } else {
+        callback_mask &= ~(1u << index);
+    }
+}
+
+void Simulator::setProfiling(bool enable)
+{
+    if(enable && profile == nullptr) {
+        profile.reset(new Profile());
+    }
+    profiling = enable;
+    state.setProfile(profiling ? profile.get() : nullptr);
+}
+
+void Simulator::clearProfile(void)
+{
+    if(profile != nullptr) {
+        profile->clear();
+    }
 }
 
 void Simulator::addBreakpoint(uint16_t pc)
 {
-    breakpoints.insert(pc);
+    breakpoints.set(pc);
 }
 
 void Simulator::removeBreakpoint(uint16_t pc)
 {
-    breakpoints.erase(pc);
+    breakpoints.reset(pc);
+}
+
+void Simulator::addBreakpoints(std::vector<uint16_t> const & pcs)
+{
+    for(uint16_t pc : pcs) {
+        breakpoints.set(pc);
+    }
 }
 
 void Simulator::powerOn(uint64_t t_delta)
 {
-    events.emplace(std::make_shared<PowerOnEvent>(time + t_delta));
+    events.push(makePooled<PowerOnEvent>(time + t_delta));
     executeEvents();
 }
 
 void Simulator::executeEvents(void)
 {
+    // Events and micro-ops are only converted to strings when tracing is enabled.
+    bool trace = logger.isEnabled(lc3::utils::PrintType::P_EXTRA);
+
     while(! events.empty()) {
-        PIEvent event = events.top();
-        events.pop();
+        PIEvent event = events.pop();
 
         if(event != nullptr) {
             if(event->time < time) {
-                logger.printf(lc3::utils::PrintType::P_WARNING, true, "%d: Skipping '%s' scheduled for %d", time,
-                    event->toString(state).c_str(), event->time);
-                logger.newline(lc3::utils::PrintType::P_WARNING);
+                warnSkippedEvent(*event);
                 continue;
             }
 
             time = event->time;
-            logger.printf(lc3::utils::PrintType::P_EXTRA, true, "%d: %s", time, event->toString(state).c_str());
+            if(trace) {
+                logger.printf(lc3::utils::PrintType::P_EXTRA, true, "%llu: %s", static_cast<unsigned long long>(time),
+                    event->toString(state).c_str());
+            }
             event->handleEvent(state);
 
             PIMicroOp uop = event->uops;
             while(uop != nullptr) {
-                logger.printf(lc3::utils::PrintType::P_EXTRA, true, "%d: |- %s", time, uop->toString(state).c_str());
+                if(trace) {
+                    logger.printf(lc3::utils::PrintType::P_EXTRA, true, "%llu: |- %s",
+                        static_cast<unsigned long long>(time), uop->toString(state).c_str());
+                }
                 uop->handleMicroOp(state);
                 uop = uop->getNext();
             }
@@ -133,46 +219,512 @@ void Simulator::executeEvents(void)
     }
 }
 
+bool Simulator::useFastEngine(void) const
+{
+    switch(engine_type) {
+        case EngineType::DETAILED: return false;
+        case EngineType::FAST:
+        case EngineType::JIT: return true;
+        default:
+            return ! inst_callbacks_active && ! logger.isEnabled(lc3::utils::PrintType::P_EXTRA);
+    }
+}
+
+void Simulator::runDetailedEngine(void)
+{
+    sim::Decoder decoder;
+
+    do {
+        handleDevices();
+        handleInstruction(decoder);
+    } while(lc3::utils::getBit(state.readMCR(), 15) == 1 && ! async_interrupt);
+}
+
+void Simulator::runFastEngine(void)
+{
+    fast_engine_active = true;
+
+    bool use_jit = engine_type == EngineType::JIT && sim::JIT::isSupported();
+
+    bool running = true;
+    while(running) {
+        // Instructions are executed a basic block at a time so that they are only fetched and decoded once.
+        sim::BasicBlock & block = block_cache.lookup(state);
+
+        // While nothing observes individual instructions and the devices are idle, the device updates and interrupt
+        // checks before each instruction have no effect.  They are skipped, and the devices are told how many ticks
+        // they missed, until an instruction accesses a device or produces a callback.
+        uint64_t idle_insts = getIdleInstCount();
+        uint64_t skipped_ticks = 0;
+        uint32_t index = 0;
+
+        // Hot blocks run natively for as long as the devices stay idle, and return to the loop below before anything
+        // they cannot handle themselves.
+        if(use_jit && idle_insts != 0 && block.length != 0) {
+            if(! jit.isCompiled(block) && ++block.exec_count >= jit_threshold && ! jit.compile(block)) {
+                use_jit = false;
+            }
+
+            if(jit.isCompiled(block)) {
+                skipped_ticks = runNative(block, idle_insts);
+                if(skipped_ticks != 0) {
+                    index = jit_context.exit_index;
+                }
+                running = isRunning();
+                if(! running || index >= block.length) {
+                    skipIdleTicks(skipped_ticks);
+                    continue;
+                }
+            }
+        }
+
+        do {
+            uint64_t inst_time = time + (INST_TIMESTEP - (time % INST_TIMESTEP));
+            if(skipped_ticks < idle_insts && inst_time - 10 >= time && canExecuteFromBlock(block, index) &&
+                ! (stop_conditions.halt && block.words[index] == 0xF025))
+            {
+                uint64_t device_accesses = state.getDeviceAccessCount();
+                time = inst_time;
+                pre_inst_pc = state.readPC();
+                interpreter.execute(state, block.words[index], *block.insts[index]);
+                index += 1;
+                skipped_ticks += 1;
+
+                if(state.getDeviceAccessCount() == device_accesses && state.getPendingCallbacks().empty()) {
+                    time = inst_time + callbackTypeToUnderlying(CallbackType::POST_INST);
+                    ++inst_count;
+                    ++inst_count_this_run;
+                    running = isRunning();
+                    continue;
+                }
+
+                skipIdleTicks(skipped_ticks);
+                idle_insts = 0;
+                skipped_ticks = 0;
+                endInstruction();
+                running = isRunning();
+                continue;
+            }
+
+            skipIdleTicks(skipped_ticks);
+            idle_insts = 0;
+            skipped_ticks = 0;
+            if(! beginInstruction()) {
+                running = false;
+                break;
+            }
+
+            if(suspend_requested) {
+                index = block.length;
+            } else if(canExecuteFromBlock(block, index)) {
+                interpreter.execute(state, block.words[index], *block.insts[index]);
+                index += 1;
+            } else {
+                // Control left the block (e.g. an interrupt was taken or a callback changed the PC) or the block was
+                // overwritten.
+                interpreter.step(state);
+                index = block.length;
+            }
+
+            endInstruction();
+            running = isRunning();
+        } while(running && index < block.length);
+
+        skipIdleTicks(skipped_ticks);
+    }
+
+    fast_engine_active = false;
+    suspend_requested = false;
+}
+
+bool Simulator::beginInstruction(void)
+{
+    // The time is kept in step with the detailed engine, which schedules everything relative to the start of the next
+    // instruction slot and skips anything that would be scheduled before the current time.  This only happens after a
+    // breakpoint or after several objects have been loaded, but then the first instruction of the next run does not
+    // update devices or check for interrupts.
+    uint64_t inst_time = time + (INST_TIMESTEP - (time % INST_TIMESTEP));
+
+    // Devices are updated and interrupts are checked before every instruction, as in handleDevices.
+    for(PIDevice & dev : devices) {
+        if(advanceTime(inst_time - 10)) {
+            sim::Interpreter::executeMicroOps(state, dev->tick());
+        } else {
+            warnSkippedEvent(DeviceUpdateEvent(inst_time - 10, dev));
+        }
+    }
+    if(advanceTime(inst_time - 9)) {
+        interpreter.checkForInterrupt(state);
+    } else {
+        warnSkippedEvent(CheckForInterruptEvent(inst_time - 9));
+    }
+
+    suspend_requested = false;
+    if(breakpoints.test(state.readPC()) && inst_count_this_run != 0) {
+        triggerSuspend();
+        dispatchCallbackAt(inst_time, CallbackType::BREAKPOINT, true);
+        return false;
+    }
+
+    // Callbacks are dispatched in the same order the detailed engine schedules them.  A suspend during the
+    // pre-instruction callbacks drops the instruction but, as in the detailed engine, not the post-instruction
+    // callback.
+    dispatchInstCallbackAt(inst_time, CallbackType::PRE_INST);
+    dispatchPendingCallbacks(inst_time);
+    if(! suspend_requested) {
+        time = inst_time;
+    }
+    return true;
+}
+
+void Simulator::endInstruction(void)
+{
+    // Post-instruction callbacks are scheduled relative to the instruction, or to the suspend if it was dropped.
+    suspend_requested = false;
+    uint64_t base_time = time;
+    dispatchPendingCallbacks(base_time);
+    dispatchInstCallbackAt(base_time, CallbackType::POST_INST);
+}
+
+bool Simulator::advanceTime(uint64_t event_time)
+{
+    if(event_time < time) {
+        return false;
+    }
+
+    time = event_time;
+    return true;
+}
+
+void Simulator::warnSkippedEvent(IEvent const & event) const
+{
+    if(logger.isEnabled(lc3::utils::PrintType::P_WARNING)) {
+        logger.printf(lc3::utils::PrintType::P_WARNING, true, "%llu: Skipping '%s' scheduled for %llu",
+            static_cast<unsigned long long>(time), event.toString(state).c_str(),
+            static_cast<unsigned long long>(event.time));
+        logger.newline(lc3::utils::PrintType::P_WARNING);
+    }
+}
+
+bool Simulator::isRunning(void) const
+{
+    return lc3::utils::getBit(state.readMCR(), 15) == 1 && ! async_interrupt;
+}
+
+uint64_t Simulator::getIdleInstCount(void) const
+{
+    // Breakpoints, watchpoints, instruction callbacks, and tracing all need every instruction to be stepped, and so
+    // does a pending interrupt, which may be taken as soon as its priority allows.
+    if(! breakpoints.empty() || state.hasWatchpoints() || hasCallback(CallbackType::PRE_INST) ||
+        hasCallback(CallbackType::POST_INST) || stop_conditions.until_depth ||
+        logger.isEnabled(lc3::utils::PrintType::P_EXTRA) || state.peekInterrupt() != InterruptType::INVALID)
+    {
+        return 0;
+    }
+
+    uint64_t count = std::numeric_limits<uint64_t>::max();
+    for(PIDevice const & dev : devices) {
+        count = std::min(count, dev->getIdleTicks());
+    }
+
+    // The instruction that reaches the limit is stepped, so that it stops the run.
+    if(stop_conditions.inst_limit != 0) {
+        uint64_t remaining = stop_conditions.inst_limit > inst_count_this_run ?
+            stop_conditions.inst_limit - inst_count_this_run - 1 : 0;
+        count = std::min(count, remaining);
+    }
+
+    return count;
+}
+
+void Simulator::skipIdleTicks(uint64_t count)
+{
+    if(count == 0) {
+        return;
+    }
+
+    for(PIDevice & dev : devices) {
+        dev->skipIdleTicks(count);
+    }
+}
+
+bool Simulator::canExecuteFromBlock(sim::BasicBlock const & block, uint32_t index) const
+{
+    return index < block.length && state.readPC() == block.start_pc + index && block_cache.isValid(block, state);
+}
+
+uint32_t Simulator::runNative(sim::BasicBlock const & block, uint64_t budget)
+{
+    // Translated code keeps the condition codes as a value that sets them, so exactly one of them must be set.  It
+    // also does not check instruction fetches, so the whole block must be accessible.
+    uint16_t psr = state.readPSR();
+    uint16_t cc = psr & 0x0007;
+    bool user = ! state.getIgnorePrivilege() && lc3::utils::getBit(psr, 15) == 1;
+    uint64_t inst_time = time + (INST_TIMESTEP - (time % INST_TIMESTEP));
+    if(inst_time - 10 < time || ! canExecuteFromBlock(block, 0) || (cc != 1 && cc != 2 && cc != 4) ||
+        (user && block.start_pc <= SYSTEM_END) || profiling)
+    {
+        return 0;
+    }
+
+    // The budget is capped so that an asynchronous interrupt is noticed promptly even in a tight loop.
+    jit_context.regs = state.getRegisterFile();
+    jit_context.mem = state.getMemory();
+    jit_context.translated_words = state.getTranslatedWords();
+    jit_context.dirty_pages = state.getDirtyPages();
+    jit_context.budget = static_cast<uint32_t>(std::min<uint64_t>(budget, 1 << 20));
+    jit_context.exit_index = 0;
+    jit_context.pc = state.readPC();
+    jit_context.psr = psr;
+    jit_context.mem_start = user ? USER_START : 0;
+
+    uint32_t count = jit_verify ? verifyNative(block) : jit.run(block, &jit_context);
+    if(count == 0) {
+        return 0;
+    }
+
+    // Everything the instructions would have done one at a time is caught up at once: the time and instruction
+    // counts advance just as they do for instructions that skip the device updates, and the IR holds the last
+    // instruction executed.
+    uint32_t last = jit_context.exit_index != 0 ? jit_context.exit_index - 1 : block.length - 1;
+    if(! jit_verify) {
+        state.writePC(jit_context.pc);
+        state.writePSR(jit_context.psr);
+        state.writeIR(block.words[last]);
+        state.writeDecodedIR(block.insts[last]);
+    }
+    pre_inst_pc = block.start_pc + last;
+    time = inst_time + (count - 1) * INST_TIMESTEP + callbackTypeToUnderlying(CallbackType::POST_INST);
+    inst_count += count;
+    inst_count_this_run += count;
+    return count;
+}
+
+uint32_t Simulator::verifyNative(sim::BasicBlock const & block)
+{
+    // The block runs natively on copies of the registers and memory, and then the same number of instructions run
+    // through the interpreter on the machine itself.  The interpreter's results are kept either way.
+    uint16_t * regs = state.getRegisterFile();
+    uint16_t * mem = state.getMemory();
+    std::copy(regs, regs + 8, jit_verify_regs);
+    jit_verify_mem.assign(mem, mem + (1 << 16));
+    std::copy(state.getDirtyPages(), state.getDirtyPages() + NUM_MEM_PAGES / 64, jit_verify_dirty_pages);
+    jit_context.regs = jit_verify_regs;
+    jit_context.mem = jit_verify_mem.data();
+    jit_context.dirty_pages = jit_verify_dirty_pages;
+
+    uint32_t count = jit.run(block, &jit_context);
+    for(uint32_t i = 0; i < count; i += 1) {
+        interpreter.step(state);
+    }
+
+    bool match = jit_context.pc == state.readPC() && jit_context.psr == state.readPSR() &&
+        std::equal(regs, regs + 8, jit_verify_regs) && std::equal(mem, mem + MMIO_START, jit_verify_mem.data());
+    if(! match) {
+        jit_verify_failures += 1;
+        logger.printf(lc3::utils::PrintType::P_ERROR, true, "JIT mismatch in block at 0x%0.4hx (%s)", block.start_pc,
+            state.getMemLine(block.start_pc).c_str());
+        logger.newline(lc3::utils::PrintType::P_ERROR);
+
+        // Leave the block, so that execution continues from wherever the interpreter ended up.
+        jit_context.exit_index = block.length;
+    }
+
+    return count;
+}
+
+bool Simulator::reachCallbackAt(uint64_t base_time, CallbackType type, bool force)
+{
+    if(suspend_requested && ! force) {
+        return false;
+    }
+
+    uint64_t event_time = base_time + callbackTypeToUnderlying(type);
+    if(! advanceTime(event_time)) {
+        warnSkippedEvent(CallbackEvent(event_time, type, nullptr));
+        return false;
+    }
+    return true;
+}
+
+void Simulator::dispatchCallbackAt(uint64_t base_time, CallbackType type, bool force)
+{
+    if(reachCallbackAt(base_time, type, force)) {
+        callbackDispatcher(this, type, state);
+    }
+}
+
+void Simulator::dispatchInstCallbackAt(uint64_t base_time, CallbackType type)
+{
+    if(hasCallback(type) || canStopOn(type)) {
+        dispatchCallbackAt(base_time, type, false);
+        return;
+    }
+
+    // Nothing consumes the callback, so only the simulator's own bookkeeping from callbackDispatcher is done.
+    if(reachCallbackAt(base_time, type, false)) {
+        if(type == CallbackType::PRE_INST) {
+            pre_inst_pc = state.readPC();
+        } else {
+            ++inst_count;
+            ++inst_count_this_run;
+        }
+    }
+}
+
+void Simulator::dispatchPendingCallbacks(uint64_t base_time)
+{
+    if(state.getPendingCallbacks().empty()) {
+        return;
+    }
+
+    // Callbacks added while these are dispatched stay pending for the next phase.
+    state.takePendingCallbacks(dispatch_callbacks);
+
+    // Pending callbacks are ordered by their offset from the instruction, just as they are in the event queue.  There
+    // are only ever a few, so an insertion sort keeps them stable without the buffer std::stable_sort allocates.
+    for(size_t i = 1; i < dispatch_callbacks.size(); i += 1) {
+        CallbackType type = dispatch_callbacks[i];
+        size_t j = i;
+        for(; j > 0 && callbackTypeToUnderlying(dispatch_callbacks[j - 1]) > callbackTypeToUnderlying(type); j -= 1) {
+            dispatch_callbacks[j] = dispatch_callbacks[j - 1];
+        }
+        dispatch_callbacks[j] = type;
+    }
+
+    for(CallbackType type : dispatch_callbacks) {
+        dispatchCallbackAt(base_time, type, false);
+    }
+}
+
 void Simulator::handleDevices(void)
 {
     uint64_t fetch_time_offset = INST_TIMESTEP - (time % INST_TIMESTEP);
 
     // Insert device update events.
-    for(PIDevice dev : devices) {
-        events.emplace(std::make_shared<DeviceUpdateEvent>(time + fetch_time_offset - 10, dev));
+    for(PIDevice const & dev : devices) {
+        events.push(makePooled<DeviceUpdateEvent>(time + fetch_time_offset - 10, dev));
     }
 
     // Check for interrupts triggered by devices.
-    events.emplace(std::make_shared<CheckForInterruptEvent>(time + fetch_time_offset - 9));
+    events.push(makePooled<CheckForInterruptEvent>(time + fetch_time_offset - 9));
     executeEvents();
 }
 
 void Simulator::handleInstruction(sim::Decoder & decoder)
 {
     uint64_t fetch_time_offset = INST_TIMESTEP - (time % INST_TIMESTEP);
+    uint64_t inst_time = time + fetch_time_offset;
+
+    // Callbacks that nothing consumes are dispatched directly, at the time their events would have run, instead of
+    // through the event queue.  The event queue is empty at the start of each phase, and a phase is only dispatched
+    // directly if none of its callbacks are consumed, so the order is the same either way.
 
     // Either insert breakpoints event or normal processing.
-    auto bp_search = std::find(breakpoints.begin(), breakpoints.end(), state.readPC());
-    if(bp_search != breakpoints.end() && inst_count_this_run != 0) {
+    if(breakpoints.test(state.readPC()) && inst_count_this_run != 0) {
         // Insert suspend event and breakpoint callbacks.
         triggerSuspend();
-        triggerCallback(fetch_time_offset, CallbackType::BREAKPOINT);
-
-        executeEvents();
+        if(needsCallbackEvents(CallbackType::BREAKPOINT)) {
+            triggerCallback(fetch_time_offset, CallbackType::BREAKPOINT);
+            executeEvents();
+        } else {
+            executeEvents();
+            dispatchCallbackAt(inst_time, CallbackType::BREAKPOINT, true);
+        }
     } else {
         // Insert pre-instruction callback and any other pending callbacks (namely, interrupt-enter).
-        triggerCallback(fetch_time_offset, CallbackType::PRE_INST);
-        handleCallbacks(fetch_time_offset);
+        if(needsCallbackEvents(CallbackType::PRE_INST)) {
+            triggerCallback(fetch_time_offset, CallbackType::PRE_INST);
+            handleCallbacks(fetch_time_offset);
+        } else {
+            dispatchInstCallbackAt(inst_time, CallbackType::PRE_INST);
+            dispatchPendingCallbacks(inst_time);
+        }
 
         // Insert instruction fetch event.
-        events.emplace(std::make_shared<AtomicInstProcessEvent>(time + fetch_time_offset, decoder));
+        events.push(makePooled<AtomicInstProcessEvent>(inst_time, decoder));
         executeEvents();
 
         // Insert post-instruction callback and any other callbacks generated during execution.
-        triggerCallback(0, CallbackType::POST_INST);
-        handleCallbacks(0);
+        if(needsCallbackEvents(CallbackType::POST_INST)) {
+            triggerCallback(0, CallbackType::POST_INST);
+            handleCallbacks(0);
+            executeEvents();
+        } else {
+            uint64_t base_time = time;
+            dispatchPendingCallbacks(base_time);
+            dispatchInstCallbackAt(base_time, CallbackType::POST_INST);
+        }
+    }
+}
 
-        executeEvents();
+bool Simulator::needsCallbackEvents(CallbackType type) const
+{
+    // Callback events are always materialized when tracing so that they show up in the trace.  They are also
+    // materialized for a phase that may end the run, because suspending drops the rest of the phase from the event
+    // queue, which a direct dispatch would not.
+    if(hasCallback(type) || canStopOn(type) || logger.isEnabled(lc3::utils::PrintType::P_EXTRA)) {
+        return true;
+    }
+
+    for(CallbackType pending : state.getPendingCallbacks()) {
+        if(hasCallback(pending) || canStopOn(pending)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool Simulator::canStopOn(CallbackType type) const
+{
+    switch(type) {
+        case CallbackType::PRE_INST: return stop_conditions.halt;
+        case CallbackType::POST_INST: return stop_conditions.inst_limit != 0 || stop_conditions.until_depth;
+        case CallbackType::INPUT_REQUEST: return stop_conditions.input_request;
+        default: return false;
+    }
+}
+
+void Simulator::checkStopConditions(CallbackType type, MachineState const & state)
+{
+    switch(type) {
+        case CallbackType::PRE_INST:
+            if(stop_conditions.halt && state.readMem(state.readPC()).first == 0xF025) {
+                triggerSuspend();
+            }
+            break;
+
+        case CallbackType::POST_INST:
+            if(stop_conditions.inst_limit != 0 && inst_count_this_run == stop_conditions.inst_limit) {
+                triggerSuspend();
+            }
+            if(stop_conditions.until_depth && run_depth == 0) {
+                triggerSuspend();
+            }
+            break;
+
+        case CallbackType::SUB_ENTER:
+        case CallbackType::EX_ENTER:
+        case CallbackType::INT_ENTER:
+            run_depth += 1;
+            break;
+
+        case CallbackType::SUB_EXIT:
+        case CallbackType::EX_EXIT:
+        case CallbackType::INT_EXIT:
+            if(run_depth > 0) {
+                run_depth -= 1;
+            }
+            break;
+
+        case CallbackType::INPUT_REQUEST:
+            if(stop_conditions.input_request) {
+                triggerSuspend();
+            }
+            break;
+
+        default: break;
     }
 }
 
@@ -187,9 +739,9 @@ void Simulator::handleCallbacks(uint64_t t_delta)
 
 void Simulator::triggerCallback(uint64_t t_delta, CallbackType type)
 {
-    events.emplace(std::make_shared<CallbackEvent>(
+    events.push(makePooled<CallbackEvent>(
         time + t_delta + callbackTypeToUnderlying(type), type,
-        std::bind(callbackDispatcher, this, type, std::placeholders::_2)
+        [this](CallbackType type, MachineState & state) { callbackDispatcher(this, type, state); }
     ));
 }
 
@@ -198,28 +750,53 @@ void Simulator::callbackDispatcher(Simulator * sim, CallbackType type, MachineSt
     if(type == CallbackType::PRE_INST) {
         sim->pre_inst_pc = state.readPC();
     } else if(type == CallbackType::SUB_ENTER || type == CallbackType::EX_ENTER || type == CallbackType::INT_ENTER) {
-        sim->stack_trace.push_back(sim->pre_inst_pc);
-        sim->logger.printf(lc3::utils::PrintType::P_DEBUG, true, "Stack trace");
-        for(int64_t i = sim->stack_trace.size() - 1; i >= 0; --i) {
-            uint16_t pc = sim->stack_trace[i];
-            sim->logger.printf(lc3::utils::PrintType::P_DEBUG, true, "#%d 0x%0.4hx (%s)",
-                sim->stack_trace.size() - 1 - i, pc, state.getMemLine(pc).c_str());
+        sim->encountered_exception = sim->encountered_exception || type == CallbackType::EX_ENTER;
+        if(sim->profiling) {
+            // The routine has been entered by now, so it is identified by its first instruction.
+            if(type != CallbackType::SUB_ENTER) {
+                std::map<uint16_t, uint64_t> & counts = type == CallbackType::INT_ENTER ? sim->profile->interrupts :
+                    sim->profile->exceptions;
+                counts[state.readPC()] += 1;
+            }
+            sim->profile->enterRoutine(state.readPC());
+        }
+        FuncType func_type = FuncType::SUBROUTINE;
+        if(type == CallbackType::INT_ENTER) {
+            func_type = FuncType::INTERRUPT;
+        } else if(type == CallbackType::EX_ENTER) {
+            func_type = FuncType::EXCEPTION;
+        } else if(state.peekFuncTraceType() == FuncType::TRAP) {
+            func_type = FuncType::TRAP;
+        }
+        sim->call_stack.push(StackFrame{sim->pre_inst_pc, state.readPC(), func_type});
+        if(sim->logger.isEnabled(lc3::utils::PrintType::P_DEBUG)) {
+            sim->logger.printf(lc3::utils::PrintType::P_DEBUG, true, "Entered %s 0x%0.4hx from 0x%0.4hx (depth %llu)",
+                funcTypeToString(func_type).c_str(), state.readPC(), sim->pre_inst_pc,
+                static_cast<unsigned long long>(sim->call_stack.getDepth()));
         }
     } else if(type == CallbackType::SUB_EXIT || type == CallbackType::EX_EXIT || type == CallbackType::INT_EXIT) {
-        sim->stack_trace.pop_back();
-        sim->logger.printf(lc3::utils::PrintType::P_DEBUG, true, "Stack trace");
-        for(int64_t i = sim->stack_trace.size() - 1; i >= 0; --i) {
-            uint16_t pc = sim->stack_trace[i];
-            sim->logger.printf(lc3::utils::PrintType::P_DEBUG, true, "#%d 0x%0.4hx (%s)",
-                sim->stack_trace.size() - 1 - i, pc, state.getMemLine(pc).c_str());
+        if(sim->profiling) {
+            sim->profile->exitRoutine();
+        }
+        sim->call_stack.pop();
+        if(sim->logger.isEnabled(lc3::utils::PrintType::P_DEBUG)) {
+            sim->logger.printf(lc3::utils::PrintType::P_DEBUG, true, "Returned to 0x%0.4hx (depth %llu)",
+                state.readPC(), static_cast<unsigned long long>(sim->call_stack.getDepth()));
         }
     } else if(type == CallbackType::POST_INST) {
+        ++(sim->inst_count);
         ++(sim->inst_count_this_run);
     }
 
-    auto search = sim->callbacks.find(type);
-    if(search != sim->callbacks.end() && search->second != nullptr) {
-        search->second(type, state);
+    // Stop conditions are checked before the callback is passed on to its consumer.
+    sim->checkStopConditions(type, state);
+
+    if(sim->hasCallback(type)) {
+        sim->callbacks[callbackTypeToIndex(type)](type, state);
+    }
+
+    if(type == CallbackType::WATCHPOINT) {
+        state.clearWatchpointHits();
     }
 }
 
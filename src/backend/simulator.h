@@ -4,34 +4,58 @@
 #ifndef SIMULATOR_H
 #define SIMULATOR_H
 
+#include <array>
 #include <cstdint>
-#include <unordered_map>
-#include <queue>
-#include <set>
+#include <memory>
+#include <vector>
 
+#include "address_bitmap.h"
+#include "block_cache.h"
+#include "call_stack.h"
 #include "inputter.h"
 #include "event.h"
+#include "event_queue.h"
+#include "interpreter.h"
+#include "jit.h"
 #include "logger.h"
 #include "printer.h"
+#include "profile.h"
+#include "snapshot.h"
 #include "state.h"
 
-namespace std
+namespace lc3
+{
+namespace core
 {
-    using namespace lc3::core;
+    // The detailed engine runs every instruction through the event queue and micro-op chains, which is required for
+    // event-level tracing.  The fast engine executes instructions directly and is otherwise indistinguishable.  AUTO
+    // selects the fast engine unless tracing is enabled or per-instruction callbacks have been registered.  JIT is the
+    // fast engine with hot blocks compiled to native code; it falls back to the fast engine on unsupported hosts.
+    enum class EngineType
+    {
+          AUTO
+        , DETAILED
+        , FAST
+        , JIT
+    };
 
-    template<> struct greater<PIEvent>
+    // Conditions that end a run early.  They are checked by the simulator itself as instructions execute, so none of
+    // them require callbacks to be dispatched.
+    struct StopConditions
     {
-        bool operator()(PIEvent lhs, PIEvent rhs)
-        {
-            return std::greater<uint64_t>()(lhs->time, rhs->time);
-        }
+        // Number of instructions to execute, or 0 for no limit.
+        uint64_t inst_limit = 0;
+        // Stop before executing a HALT.
+        bool halt = false;
+        // Stop when the program reads the keyboard status register and no input is available.
+        bool input_request = false;
+        // Stop once the program has returned from depth subroutines, traps, exceptions, or interrupts.  Those entered
+        // during the run must be returned from as well, so a depth of 0 stops after the next instruction that does not
+        // enter one.
+        bool until_depth = false;
+        uint64_t depth = 0;
     };
-};
 
-namespace lc3
-{
-namespace core
-{
     class Simulator
     {
     public:
@@ -40,21 +64,49 @@ namespace core
         Simulator(lc3::utils::IPrinter & printer, lc3::utils::IInputter & inputter, uint32_t print_level);
         void simulate(void);
         void loadObj(std::string const & name, std::istream & buffer);
+        void loadImage(std::string const & name, MemImage const & image);
         void setup(uint64_t t_delta = 0);
         void reinitialize(void);
         void triggerSuspend();
         void registerCallback(CallbackType type, Callback func);
+        bool hasCallback(CallbackType type) const { return ((callback_mask >> callbackTypeToIndex(type)) & 1) == 1; }
         void addBreakpoint(uint16_t pc);
         void removeBreakpoint(uint16_t pc);
+        void addBreakpoints(std::vector<uint16_t> const & pcs);
+        void clearBreakpoints(void) { breakpoints.clear(); }
+        std::vector<uint16_t> getBreakpoints(void) const { return breakpoints.list(); }
         MachineState & getMachineState(void);
         MachineState const & getMachineState(void) const;
         void asyncInterrupt(void) { async_interrupt = true; }
+        // Applies to every following run until it is changed.
+        void setStopConditions(StopConditions const & conditions) { stop_conditions = conditions; }
+        StopConditions const & getStopConditions(void) const { return stop_conditions; }
+        bool didEncounterException(void) const { return encountered_exception; }
+        // Snapshots may only be taken and restored between runs.  A snapshot can be restored into any simulator.
+        PSnapshot saveSnapshot(void);
+        void restoreSnapshot(PSnapshot const & snapshot);
 
         void setPrintLevel(uint32_t print_level);
         void setIgnorePrivilege(bool ignore_privilege);
+        void setEngineType(EngineType type) { engine_type = type; }
+        EngineType getEngineType(void) const { return engine_type; }
+        void setInstCallbacksActive(bool active) { inst_callbacks_active = active; }
+        void setJITThreshold(uint32_t threshold) { jit_threshold = threshold; }
+        void setJITVerify(bool verify) { jit_verify = verify; }
+        uint64_t getJITVerifyFailures(void) const { return jit_verify_failures; }
+
+        uint64_t getInstExecCount(void) const { return inst_count; }
+        // The profile is kept when profiling is disabled, and counting resumes where it left off when it is enabled
+        // again, though calls and returns made in between are missed.  It is null until profiling is first enabled.
+        void setProfiling(bool enable);
+        bool isProfiling(void) const { return profiling; }
+        void clearProfile(void);
+        Profile const * getProfile(void) const { return profile.get(); }
+        CallStack const & getCallStack(void) const { return call_stack; }
+        lc3::utils::Logger const & getLogger(void) const { return logger; }
 
     private:
-        std::priority_queue<PIEvent, std::vector<PIEvent>, std::greater<PIEvent>> events;
+        EventQueue events;
         uint64_t time;
 
         MachineState state;
@@ -62,20 +114,68 @@ namespace core
 
         lc3::utils::Logger logger;
 
-        std::unordered_map<CallbackType, Callback> callbacks;
-        std::set<uint16_t> breakpoints;
+        // Only callback types with a registered consumer are set in callback_mask.  The rest are handled natively:
+        // they are not materialized as events, except when tracing, and are not dispatched.
+        std::array<Callback, NUM_CALLBACK_TYPES> callbacks;
+        uint32_t callback_mask;
+        AddressBitmap breakpoints;
 
-        uint64_t inst_count_this_run;
+        uint64_t inst_count, inst_count_this_run;
         uint16_t pre_inst_pc;
-        std::vector<uint16_t> stack_trace;
+        CallStack call_stack;
         bool async_interrupt;
 
+        std::unique_ptr<Profile> profile;
+        bool profiling;
+
+        StopConditions stop_conditions;
+        uint64_t run_depth;
+        bool encountered_exception;
+
+        EngineType engine_type;
+        bool inst_callbacks_active;
+        bool fast_engine_active;
+        bool suspend_requested;
+        std::vector<CallbackType> dispatch_callbacks;
+        sim::Interpreter interpreter;
+        sim::BlockCache block_cache;
+
+        sim::JIT jit;
+        sim::JITContext jit_context;
+        uint32_t jit_threshold;
+        bool jit_verify;
+        uint64_t jit_verify_failures;
+        std::vector<uint16_t> jit_verify_mem;
+        uint16_t jit_verify_regs[8];
+        uint64_t jit_verify_dirty_pages[NUM_MEM_PAGES / 64];
+
         void powerOn(uint64_t t_delta);
         void executeEvents(void);
         void handleDevices(void);
         void handleInstruction(sim::Decoder & decoder);
         void handleCallbacks(uint64_t t_delta);
         void triggerCallback(uint64_t t_delta, CallbackType type);
+        bool needsCallbackEvents(CallbackType type) const;
+        bool canStopOn(CallbackType type) const;
+        void checkStopConditions(CallbackType type, MachineState const & state);
+
+        bool useFastEngine(void) const;
+        void runDetailedEngine(void);
+        void runFastEngine(void);
+        bool beginInstruction(void);
+        void endInstruction(void);
+        bool isRunning(void) const;
+        uint64_t getIdleInstCount(void) const;
+        void skipIdleTicks(uint64_t count);
+        bool canExecuteFromBlock(sim::BasicBlock const & block, uint32_t index) const;
+        bool advanceTime(uint64_t event_time);
+        void warnSkippedEvent(IEvent const & event) const;
+        bool reachCallbackAt(uint64_t base_time, CallbackType type, bool force);
+        void dispatchCallbackAt(uint64_t base_time, CallbackType type, bool force);
+        void dispatchInstCallbackAt(uint64_t base_time, CallbackType type);
+        void dispatchPendingCallbacks(uint64_t base_time);
+        uint32_t runNative(sim::BasicBlock const & block, uint64_t budget);
+        uint32_t verifyNative(sim::BasicBlock const & block);
 
         static void callbackDispatcher(Simulator * sim, CallbackType type, MachineState & state);
     };
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <stack>
+#include <vector>
+
+#include "call_stack.h"
+#include "func_type.h"
+#include "intex.h"
+#include "mem.h"
+
+namespace lc3
+{
+namespace core
+{
+    // Memory is captured in 256-word pages, the same pages that track translated code.  Pages are immutable once
+    // captured, so a page that has not been written since the last snapshot or restore is shared rather than copied.
+    static constexpr uint32_t MEM_PAGE_SIZE = 1 << 8;
+    static constexpr uint32_t NUM_MEM_PAGES = (1 << 16) / MEM_PAGE_SIZE;
+
+    using MemPage = std::array<uint16_t, MEM_PAGE_SIZE>;
+    using PMemPage = std::shared_ptr<MemPage const>;
+
+    struct MachineSnapshot
+    {
+        std::array<PMemPage, NUM_MEM_PAGES> pages;
+        std::shared_ptr<MemLineTable const> lines;
+        std::vector<uint16_t> rf;
+        uint16_t reset_pc, pc, ir, ssp, psr, mcr;
+        std::queue<InterruptType> pending_interrupts;
+        std::stack<FuncType> func_trace;
+        bool first_init;
+    };
+
+    // Everything needed to put a simulator back into the state it was in between two runs: the machine state, the
+    // device registers and buffered input, and the simulated time.  Breakpoints, watchpoints, callbacks, and settings
+    // are not part of a snapshot.
+    struct Snapshot
+    {
+        MachineSnapshot state;
+        std::vector<std::vector<uint16_t>> devices;
+        uint64_t time;
+        uint16_t pre_inst_pc;
+        CallStack call_stack;
+    };
+
+    using PSnapshot = std::shared_ptr<Snapshot const>;
+};
+};
+
+#endif
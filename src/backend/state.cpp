@@ -1,19 +1,19 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include <algorithm>
+
 #include "device_regs.h"
 #include "device.h"
 #include "state.h"
 
 using namespace lc3::core;
 
-MachineState::MachineState(void) : reset_pc(RESET_PC), pc(0), ir(0), decoded_ir(nullptr), ssp(0),
-    ignore_privilege(false), first_init(true)
+MachineState::MachineState(void) : lines_dirty(true), psr(0), mcr(0), device_accesses(0), watchpoints_set(false),
+    reset_pc(RESET_PC), pc(0), ir(0), decoded_ir(nullptr), profile(nullptr), ssp(0), ignore_privilege(false),
+    first_init(true)
 {
     reinitialize();
-
-    registerDeviceReg(PSR, std::make_shared<RWReg>(PSR));
-    registerDeviceReg(MCR, std::make_shared<RWReg>(MCR));
 }
 
 void MachineState::reinitialize(void)
@@ -21,8 +21,17 @@ void MachineState::reinitialize(void)
     reset_pc = RESET_PC;
     first_init = true;
 
-    mem.clear();
-    mem.resize(USER_END - SYSTEM_START + 1);
+    mem.assign(1 << 16, 0);
+    mem_lines.clear();
+    dirty_pages.fill(~0ull);
+    lines_dirty = true;
+
+    // Generations are never reset, otherwise a stale translation could appear to be current.
+    page_generations.resize(1 << 8);
+    for(uint32_t & generation : page_generations) {
+        generation += 1;
+    }
+    translated_words.assign((1 << 16) / 64, 0);
 
     rf.clear();
     rf.resize(16);
@@ -34,26 +43,44 @@ bool MachineState::getIgnorePrivilege(void) const { return ignore_privilege; }
 std::pair<uint16_t, PIMicroOp> MachineState::readMem(uint16_t addr) const
 {
     if(MMIO_START <= addr && addr <= MMIO_END) {
-        auto search = mmio.find(addr);
-        if(search != mmio.end()) {
-            return search->second->read(addr);
+        if(addr == PSR) {
+            return std::make_pair(psr, nullptr);
+        } else if(addr == MCR) {
+            return std::make_pair(mcr, nullptr);
+        }
+
+        PIDevice const & device = mmio[addr - MMIO_START];
+        if(device != nullptr) {
+            device_accesses += 1;
+            return device->read(addr);
         } else {
             return std::make_pair(0x0000, nullptr);
         }
     } else {
-        return std::make_pair(mem[addr].getValue(), nullptr);
+        return std::make_pair(mem[addr], nullptr);
     }
 }
 
 PIMicroOp MachineState::writeMem(uint16_t addr, uint16_t value)
 {
     if(MMIO_START <= addr && addr <= MMIO_END) {
-        auto search = mmio.find(addr);
-        if(search != mmio.end()) {
-            return search->second->write(addr, value);
+        if(addr == PSR) {
+            psr = value;
+        } else if(addr == MCR) {
+            mcr = value;
+        } else {
+            PIDevice const & device = mmio[addr - MMIO_START];
+            if(device != nullptr) {
+                device_accesses += 1;
+                return device->write(addr, value);
+            }
         }
     } else {
-        mem[addr].setValue(value);
+        mem[addr] = value;
+        markPageDirty(addr);
+        if(((translated_words[addr >> 6] >> (addr & 0x3F)) & 1) == 1) {
+            page_generations[addr >> 8] += 1;
+        }
     }
 
     return nullptr;
@@ -62,7 +89,7 @@ PIMicroOp MachineState::writeMem(uint16_t addr, uint16_t value)
 std::string MachineState::getMemLine(uint16_t addr) const
 {
     if(addr < MMIO_START) {
-        return mem[addr].getLine();
+        return mem_lines.getLine(addr);
     }
 
     return "";
@@ -71,13 +98,170 @@ std::string MachineState::getMemLine(uint16_t addr) const
 void MachineState::setMemLine(uint16_t addr, std::string const & value)
 {
     if(addr < MMIO_START) {
-        mem[addr].setLine(value);
+        mem_lines.setLine(addr, value);
+        lines_dirty = true;
     }
 }
 
 void MachineState::registerDeviceReg(uint16_t mem_addr, PIDevice device)
 {
-    mmio[mem_addr] = device;
+    if(MMIO_START <= mem_addr && mem_addr <= MMIO_END) {
+        mmio[mem_addr - MMIO_START] = device;
+    }
+}
+
+void MachineState::saveSnapshot(MachineSnapshot & snapshot)
+{
+    for(uint32_t page = 0; page < NUM_MEM_PAGES; page += 1) {
+        if(isPageDirty(page) || snapshot_pages[page] == nullptr) {
+            std::shared_ptr<MemPage> copy = std::make_shared<MemPage>();
+            std::copy_n(mem.begin() + page * MEM_PAGE_SIZE, MEM_PAGE_SIZE, copy->begin());
+            snapshot_pages[page] = copy;
+        }
+        snapshot.pages[page] = snapshot_pages[page];
+    }
+    dirty_pages.fill(0);
+
+    if(lines_dirty || snapshot_lines == nullptr) {
+        snapshot_lines = std::make_shared<MemLineTable>(mem_lines);
+        lines_dirty = false;
+    }
+    snapshot.lines = snapshot_lines;
+
+    snapshot.rf = rf;
+    snapshot.reset_pc = reset_pc;
+    snapshot.pc = pc;
+    snapshot.ir = ir;
+    snapshot.ssp = ssp;
+    snapshot.psr = psr;
+    snapshot.mcr = mcr;
+    snapshot.pending_interrupts = pending_interrupts;
+    snapshot.func_trace = func_trace;
+    snapshot.first_init = first_init;
+}
+
+void MachineState::restoreSnapshot(MachineSnapshot const & snapshot)
+{
+    for(uint32_t page = 0; page < NUM_MEM_PAGES; page += 1) {
+        if(! isPageDirty(page) && snapshot_pages[page] == snapshot.pages[page]) {
+            continue;
+        }
+
+        std::copy(snapshot.pages[page]->begin(), snapshot.pages[page]->end(), mem.begin() + page * MEM_PAGE_SIZE);
+        snapshot_pages[page] = snapshot.pages[page];
+
+        // Only pages with translated words need to invalidate their cached blocks.
+        uint32_t first_word = page * (MEM_PAGE_SIZE / 64);
+        for(uint32_t word = first_word; word < first_word + MEM_PAGE_SIZE / 64; word += 1) {
+            if(translated_words[word] != 0) {
+                page_generations[page] += 1;
+                break;
+            }
+        }
+    }
+    dirty_pages.fill(0);
+
+    if(lines_dirty || snapshot_lines != snapshot.lines) {
+        mem_lines = *snapshot.lines;
+        snapshot_lines = snapshot.lines;
+        lines_dirty = false;
+    }
+
+    rf = snapshot.rf;
+    reset_pc = snapshot.reset_pc;
+    pc = snapshot.pc;
+    ir = snapshot.ir;
+    // The decoded instruction belongs to whichever decoder or block produced it, so it is not carried over.
+    decoded_ir = nullptr;
+    ssp = snapshot.ssp;
+    psr = snapshot.psr;
+    mcr = snapshot.mcr;
+    pending_interrupts = snapshot.pending_interrupts;
+    func_trace = snapshot.func_trace;
+    first_init = snapshot.first_init;
+
+    pending_callbacks.clear();
+    watchpoint_hits.clear();
+}
+
+void MachineState::addWatchpoint(uint16_t start, uint16_t end, WatchpointType type)
+{
+    AddressBitmap & bitmap = getWatchpointBitmap(type);
+    for(uint32_t addr = start; addr <= end; addr += 1) {
+        bitmap.set(static_cast<uint16_t>(addr));
+    }
+    watchpoints_set = ! (read_watchpoints.empty() && write_watchpoints.empty() && change_watchpoints.empty());
+}
+
+void MachineState::removeWatchpoint(uint16_t start, uint16_t end, WatchpointType type)
+{
+    AddressBitmap & bitmap = getWatchpointBitmap(type);
+    for(uint32_t addr = start; addr <= end; addr += 1) {
+        bitmap.reset(static_cast<uint16_t>(addr));
+    }
+    watchpoints_set = ! (read_watchpoints.empty() && write_watchpoints.empty() && change_watchpoints.empty());
+}
+
+void MachineState::clearWatchpoints(void)
+{
+    read_watchpoints.clear();
+    write_watchpoints.clear();
+    change_watchpoints.clear();
+    watchpoints_set = false;
+}
+
+std::vector<std::pair<uint16_t, WatchpointType>> MachineState::getWatchpoints(void) const
+{
+    std::vector<std::pair<uint16_t, WatchpointType>> ret;
+    for(uint16_t addr : read_watchpoints.list()) { ret.emplace_back(addr, WatchpointType::READ); }
+    for(uint16_t addr : write_watchpoints.list()) { ret.emplace_back(addr, WatchpointType::WRITE); }
+    for(uint16_t addr : change_watchpoints.list()) { ret.emplace_back(addr, WatchpointType::CHANGE); }
+    return ret;
+}
+
+AddressBitmap & MachineState::getWatchpointBitmap(WatchpointType type)
+{
+    switch(type) {
+        case WatchpointType::READ: return read_watchpoints;
+        case WatchpointType::WRITE: return write_watchpoints;
+        case WatchpointType::CHANGE: return change_watchpoints;
+        default: throw lc3::utils::exception("invalid watchpoint type");
+    }
+}
+
+void MachineState::checkReadWatchpoint(uint16_t addr, uint16_t value)
+{
+    if(read_watchpoints.test(addr)) {
+        recordWatchpointHit(WatchpointHit(addr, value, value, WatchpointType::READ));
+    }
+}
+
+void MachineState::checkWriteWatchpoint(uint16_t addr, uint16_t value)
+{
+    bool watch_write = write_watchpoints.test(addr);
+    bool watch_change = change_watchpoints.test(addr);
+    if(! watch_write && ! watch_change) {
+        return;
+    }
+
+    // Device side effects of reading the old value are dropped.
+    uint16_t old_value = readMem(addr).first;
+    if(watch_write) {
+        recordWatchpointHit(WatchpointHit(addr, old_value, value, WatchpointType::WRITE));
+    }
+    if(watch_change && old_value != value) {
+        recordWatchpointHit(WatchpointHit(addr, old_value, value, WatchpointType::CHANGE));
+    }
+}
+
+void MachineState::recordWatchpointHit(WatchpointHit const & hit)
+{
+    // Every hit since the last watchpoint callback is reported by a single callback.
+    watchpoint_hits.push_back(hit);
+    auto search = std::find(pending_callbacks.begin(), pending_callbacks.end(), CallbackType::WATCHPOINT);
+    if(search == pending_callbacks.end()) {
+        addPendingCallback(CallbackType::WATCHPOINT);
+    }
 }
 
 InterruptType MachineState::peekInterrupt(void) const
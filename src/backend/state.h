@@ -4,26 +4,29 @@
 #ifndef STATE_H
 #define STATE_H
 
+#include <array>
 #include <queue>
 #include <stack>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <utility>
 
+#include "address_bitmap.h"
 #include "aliases.h"
 #include "callback.h"
 #include "device.h"
 #include "func_type.h"
 #include "intex.h"
 #include "mem.h"
+#include "profile.h"
+#include "snapshot.h"
+#include "watchpoint.h"
 
 namespace lc3
 {
 namespace core
 {
-    class IEvent;
-    using PIEvent = std::shared_ptr<IEvent>;
+    namespace sim { struct DecodedInstruction; };
 
     class MachineState
     {
@@ -41,29 +44,79 @@ namespace core
 
         uint16_t readIR(void) const { return ir; }
         void writeIR(uint16_t value) { ir = value; }
-
-        PIInstruction readDecodedIR(void) const { return decoded_ir; }
-        void writeDecodedIR(PIInstruction value) { decoded_ir = value; }
+        // Every engine calls this once it has fetched an instruction.  It costs a single branch unless profiling.
+        void recordFetch(uint16_t value)
+        {
+            if(profile != nullptr) {
+                profile->recordFetch(pc, value, psr);
+            }
+        }
+        void setProfile(Profile * value) { profile = value; }
+
+        sim::DecodedInstruction const * readDecodedIR(void) const { return decoded_ir; }
+        void writeDecodedIR(sim::DecodedInstruction const * value) { decoded_ir = value; }
 
         uint16_t readSSP(void) const { return ssp; }
         void writeSSP(uint16_t value) { ssp = value; }
 
-        uint16_t readPSR(void) const { return std::get<0>(readMem(PSR)); }
-        void writePSR(uint16_t value) { writeMem(PSR, value); }
+        uint16_t readPSR(void) const { return psr; }
+        void writePSR(uint16_t value) { psr = value; }
 
-        uint16_t readMCR(void) const { return std::get<0>(readMem(MCR)); }
-        void writeMCR(uint16_t value) { writeMem(MCR, value); }
+        uint16_t readMCR(void) const { return mcr; }
+        void writeMCR(uint16_t value) { mcr = value; }
 
         uint16_t readReg(uint16_t id) const { return rf[id]; }
         void writeReg(uint16_t id, uint16_t value) { rf[id] = value; }
 
+        // Translated code reads and writes the register file and ordinary memory in place, so it also has to mark the
+        // pages it writes dirty and leave writes to translated words to writeMem.
+        uint16_t * getRegisterFile(void) { return rf.data(); }
+        uint16_t * getMemory(void) { return mem.data(); }
+        uint64_t const * getTranslatedWords(void) const { return translated_words.data(); }
+        uint64_t * getDirtyPages(void) { return dirty_pages.data(); }
+
         std::pair<uint16_t, PIMicroOp> readMem(uint16_t addr) const;
         PIMicroOp writeMem(uint16_t addr, uint16_t value);
+        // Counts every read or write that reaches a device, which tells the simulator when device state may have
+        // changed.
+        uint64_t getDeviceAccessCount(void) const { return device_accesses; }
+        uint32_t getPageGeneration(uint16_t addr) const { return page_generations[addr >> 8]; }
+        void markTranslated(uint16_t addr) { translated_words[addr >> 6] |= 1ull << (addr & 0x3F); }
+        // Loads and stores made by the program go through these, so that they are checked against the watchpoints.
+        // Everything else (the debugger, loading objects, tracing) uses readMem and writeMem directly.
+        std::pair<uint16_t, PIMicroOp> loadMem(uint16_t addr)
+        {
+            std::pair<uint16_t, PIMicroOp> ret = readMem(addr);
+            if(watchpoints_set) {
+                checkReadWatchpoint(addr, ret.first);
+            }
+            return ret;
+        }
+        PIMicroOp storeMem(uint16_t addr, uint16_t value)
+        {
+            if(watchpoints_set) {
+                checkWriteWatchpoint(addr, value);
+            }
+            return writeMem(addr, value);
+        }
         std::string getMemLine(uint16_t addr) const;
         void setMemLine(uint16_t addr, std::string const & value);
 
         void registerDeviceReg(uint16_t mem_addr, PIDevice device);
 
+        // Taking a snapshot only copies the pages written since the last snapshot or restore, and restoring one only
+        // copies back the pages that differ from it.  Pending callbacks and watchpoint hits are discarded on restore.
+        void saveSnapshot(MachineSnapshot & snapshot);
+        void restoreSnapshot(MachineSnapshot const & snapshot);
+
+        void addWatchpoint(uint16_t start, uint16_t end, WatchpointType type);
+        void removeWatchpoint(uint16_t start, uint16_t end, WatchpointType type);
+        void clearWatchpoints(void);
+        std::vector<std::pair<uint16_t, WatchpointType>> getWatchpoints(void) const;
+        bool hasWatchpoints(void) const { return watchpoints_set; }
+        std::vector<WatchpointHit> const & getWatchpointHits(void) const { return watchpoint_hits; }
+        void clearWatchpointHits(void) { watchpoint_hits.clear(); }
+
         void enqueueInterrupt(InterruptType type) { pending_interrupts.push(type); }
         InterruptType peekInterrupt(void) const;
         InterruptType dequeueInterrupt(void);
@@ -78,15 +131,46 @@ namespace core
 
         std::vector<CallbackType> const & getPendingCallbacks(void) const { return pending_callbacks; }
         void clearPendingCallbacks(void) { pending_callbacks.clear(); }
+        // Moves the pending callbacks into callbacks, swapping buffers so that neither side has to allocate.
+        void takePendingCallbacks(std::vector<CallbackType> & callbacks)
+        {
+            callbacks.clear();
+            callbacks.swap(pending_callbacks);
+        }
         void addPendingCallback(CallbackType type) { pending_callbacks.push_back(type); }
 
     private:
-        // Hardware state.
-        std::vector<MemLocation> mem;
+        // Hardware state.  Memory is a flat word array covering the whole address space (though device registers are
+        // never stored in it), which keeps the words contiguous for the read/write paths and bulk operations.  Source
+        // lines are kept separately.
+        std::vector<uint16_t> mem;
+        MemLineTable mem_lines;
+        // Memory is divided into 256-word pages.  A page's generation is incremented whenever a word in it that has
+        // been translated into a cached block is written, which lets the cached blocks detect that they are stale.
+        // Writes to data that has never been executed do not invalidate anything.
+        std::vector<uint32_t> page_generations;
+        std::vector<uint64_t> translated_words;
+        // The same pages are marked dirty when written.  A clean page always matches its entry in snapshot_pages,
+        // which holds the pages most recently captured or restored, and likewise for the source lines.
+        std::array<PMemPage, NUM_MEM_PAGES> snapshot_pages;
+        std::array<uint64_t, NUM_MEM_PAGES / 64> dirty_pages;
+        std::shared_ptr<MemLineTable const> snapshot_lines;
+        bool lines_dirty;
         std::vector<uint16_t> rf;
-        std::unordered_map<uint16_t, PIDevice> mmio;
+        // PSR and MCR are accessed by nearly every instruction, so they are plain fields that their device register
+        // addresses alias.  Every other device register is dispatched through a table indexed by its offset from
+        // MMIO_START.
+        uint16_t psr, mcr;
+        std::array<PIDevice, MMIO_END - MMIO_START + 1> mmio;
+        mutable uint64_t device_accesses;
+        // Watched addresses are kept in bitmaps alongside memory.  watchpoints_set caches whether any of them are
+        // non-empty, so that an unwatched access costs a single branch.
+        AddressBitmap read_watchpoints, write_watchpoints, change_watchpoints;
+        bool watchpoints_set;
+        std::vector<WatchpointHit> watchpoint_hits;
         uint16_t reset_pc, pc, ir;
-        PIInstruction decoded_ir;
+        sim::DecodedInstruction const * decoded_ir;
+        Profile * profile;
         uint16_t ssp;
         std::queue<InterruptType> pending_interrupts;
 
@@ -96,6 +180,13 @@ namespace core
 
         std::stack<FuncType> func_trace;
         std::vector<CallbackType> pending_callbacks;
+
+        void markPageDirty(uint16_t addr) { dirty_pages[addr >> 14] |= 1ull << ((addr >> 8) & 0x3F); }
+        bool isPageDirty(uint32_t page) const { return ((dirty_pages[page >> 6] >> (page & 0x3F)) & 1) == 1; }
+        AddressBitmap & getWatchpointBitmap(WatchpointType type);
+        void checkReadWatchpoint(uint16_t addr, uint16_t value);
+        void checkWriteWatchpoint(uint16_t addr, uint16_t value);
+        void recordWatchpointHit(WatchpointHit const & hit);
     };
 };
 };
@@ -0,0 +1,34 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "symbolizer.h"
+
+#include <iterator>
+
+#include "utils.h"
+
+using namespace lc3::core;
+
+void Symbolizer::addSymbols(SymbolTable const & symbols)
+{
+    for(auto const & symbol : symbols) {
+        labels.emplace(static_cast<uint16_t>(symbol.second), symbol.first);
+    }
+}
+
+std::string Symbolizer::symbolize(uint16_t addr) const
+{
+    auto search = labels.upper_bound(addr);
+    if(search == labels.begin()) {
+        return "";
+    }
+    search = std::prev(search);
+
+    uint32_t offset = addr - search->first;
+    if(offset == 0) {
+        return search->second;
+    } else if(offset <= MAX_OFFSET) {
+        return lc3::utils::ssprintf("%s+%u", search->second.c_str(), offset);
+    }
+    return "";
+}
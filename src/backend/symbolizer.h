@@ -0,0 +1,39 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef SYMBOLIZER_H
+#define SYMBOLIZER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "aliases.h"
+
+namespace lc3
+{
+namespace core
+{
+    // Names addresses after the closest label at or before them, using the symbol tables produced by the assembler.
+    class Symbolizer
+    {
+    public:
+        // An address further than this past the closest label is assumed not to belong to it, since the label is most
+        // likely in another program.
+        static constexpr uint32_t MAX_OFFSET = 0x400;
+
+        // Labels at an address that already has one are ignored.
+        void addSymbols(SymbolTable const & symbols);
+        void clear(void) { labels.clear(); }
+        bool empty(void) const { return labels.empty(); }
+
+        // Returns "LABEL" or "LABEL+N", or an empty string if no label is close enough.
+        std::string symbolize(uint16_t addr) const;
+
+    private:
+        std::map<uint16_t, std::string> labels;
+    };
+};
+};
+
+#endif
@@ -35,11 +35,11 @@ std::string IMicroOp::regToString(uint16_t reg_id) const
 void FetchMicroOp::handleMicroOp(MachineState & state)
 {
     if(isAccessViolation(state.readPC(), state)) {
-        PIMicroOp msg = std::make_shared<PrintMessageMicroOp>("illegal memory access (ACV)");
+        PIMicroOp msg = makePooled<PrintMessageMicroOp>("illegal memory access (ACV)");
         std::pair<PIMicroOp, PIMicroOp> handle_exception_chain = buildSystemModeEnter(INTEX_TABLE_START, 0x2,
             lc3::utils::getBits(state.readPSR(), 10, 8));
-        PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::EX_ENTER);
-        PIMicroOp func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
+        PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::EX_ENTER);
+        PIMicroOp func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
 
         msg->insert(handle_exception_chain.first);
         handle_exception_chain.second->insert(callback);
@@ -49,6 +49,7 @@ void FetchMicroOp::handleMicroOp(MachineState & state)
     } else {
         uint16_t value = std::get<0>(state.readMem(state.readPC()));
         state.writeIR(value);
+        state.recordFetch(value);
     }
 }
 
@@ -60,17 +61,17 @@ std::string FetchMicroOp::toString(MachineState const & state) const
 
 void DecodeMicroOp::handleMicroOp(MachineState & state)
 {
-    lc3::optional<PIInstruction> inst = decoder.decode(state.readIR());
-    if(inst) {
-        insert((*inst)->buildMicroOps(state));
-        state.writeDecodedIR(*inst);
+    sim::DecodedInstruction const & decoded = decoder.decode(state.readIR());
+    if(decoded.inst != nullptr) {
+        insert(decoded.inst->buildMicroOps(state, decoded));
+        state.writeDecodedIR(&decoded);
     } else {
-        PIMicroOp msg = std::make_shared<PrintMessageMicroOp>("unknown opcode");
-        PIMicroOp dec_pc = std::make_shared<PCAddImmMicroOp>(-1);
+        PIMicroOp msg = makePooled<PrintMessageMicroOp>("unknown opcode");
+        PIMicroOp dec_pc = makePooled<PCAddImmMicroOp>(-1);
         std::pair<PIMicroOp, PIMicroOp> handle_exception_chain = buildSystemModeEnter(INTEX_TABLE_START, 0x1,
             lc3::utils::getBits(state.readPSR(), 10, 8));
-        PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::EX_ENTER);
-        PIMicroOp func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
+        PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::EX_ENTER);
+        PIMicroOp func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
 
         msg->insert(dec_pc);
         dec_pc->insert(handle_exception_chain.first);
@@ -83,10 +84,9 @@ void DecodeMicroOp::handleMicroOp(MachineState & state)
 
 std::string DecodeMicroOp::toString(MachineState const & state) const
 {
-    lc3::optional<PIInstruction> inst = decoder.decode(state.readIR());
-    if(inst) {
-        (*inst)->buildMicroOps(state);
-        return lc3::utils::ssprintf("dIR <= %s", (*inst)->toValueString().c_str());
+    sim::DecodedInstruction const & decoded = decoder.decode(state.readIR());
+    if(decoded.inst != nullptr) {
+        return lc3::utils::ssprintf("dIR <= %s", decoded.inst->toValueString(state.readIR()).c_str());
     } else {
         return "dIR <= Illegal instruction";
     }
@@ -261,12 +261,12 @@ void MemReadMicroOp::handleMicroOp(MachineState & state)
 {
     uint16_t addr = state.readReg(addr_reg_id);
     if(isAccessViolation(addr, state)) {
-        PIMicroOp msg = std::make_shared<PrintMessageMicroOp>("illegal memory access (ACV)");
-        PIMicroOp dec_pc = std::make_shared<PCAddImmMicroOp>(-1);
+        PIMicroOp msg = makePooled<PrintMessageMicroOp>("illegal memory access (ACV)");
+        PIMicroOp dec_pc = makePooled<PCAddImmMicroOp>(-1);
         std::pair<PIMicroOp, PIMicroOp> handle_exception_chain = buildSystemModeEnter(INTEX_TABLE_START, 0x2,
             lc3::utils::getBits(state.readPSR(), 10, 8));
-        PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::EX_ENTER);
-        PIMicroOp func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
+        PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::EX_ENTER);
+        PIMicroOp func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
 
         msg->insert(dec_pc);
         dec_pc->insert(handle_exception_chain.first);
@@ -275,7 +275,7 @@ void MemReadMicroOp::handleMicroOp(MachineState & state)
 
         next = msg;
     } else {
-        std::pair<uint16_t, PIMicroOp> read_result = state.readMem(addr);
+        std::pair<uint16_t, PIMicroOp> read_result = state.loadMem(addr);
 
         uint16_t value = std::get<0>(read_result);
         PIMicroOp op = std::get<1>(read_result);
@@ -299,12 +299,12 @@ void MemWriteImmMicroOp::handleMicroOp(MachineState & state)
 {
     uint16_t addr = state.readReg(addr_reg_id);
     if(isAccessViolation(addr, state)) {
-        PIMicroOp msg = std::make_shared<PrintMessageMicroOp>("illegal memory access (ACV)");
-        PIMicroOp dec_pc = std::make_shared<PCAddImmMicroOp>(-1);
+        PIMicroOp msg = makePooled<PrintMessageMicroOp>("illegal memory access (ACV)");
+        PIMicroOp dec_pc = makePooled<PCAddImmMicroOp>(-1);
         std::pair<PIMicroOp, PIMicroOp> handle_exception_chain = buildSystemModeEnter(INTEX_TABLE_START, 0x2,
             lc3::utils::getBits(state.readPSR(), 10, 8));
-        PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::EX_ENTER);
-        PIMicroOp func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
+        PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::EX_ENTER);
+        PIMicroOp func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
 
         msg->insert(dec_pc);
         dec_pc->insert(handle_exception_chain.first);
@@ -313,7 +313,7 @@ void MemWriteImmMicroOp::handleMicroOp(MachineState & state)
 
         next = msg;
     } else {
-        PIMicroOp op = state.writeMem(addr, value);
+        PIMicroOp op = state.storeMem(addr, value);
 
         if(op) {
             insert(op);
@@ -331,12 +331,12 @@ void MemWriteRegMicroOp::handleMicroOp(MachineState & state)
 {
     uint16_t addr = state.readReg(addr_reg_id);
     if(isAccessViolation(addr, state)) {
-        PIMicroOp msg = std::make_shared<PrintMessageMicroOp>("illegal memory access (ACV)");
-        PIMicroOp dec_pc = std::make_shared<PCAddImmMicroOp>(-1);
+        PIMicroOp msg = makePooled<PrintMessageMicroOp>("illegal memory access (ACV)");
+        PIMicroOp dec_pc = makePooled<PCAddImmMicroOp>(-1);
         std::pair<PIMicroOp, PIMicroOp> handle_exception_chain = buildSystemModeEnter(INTEX_TABLE_START, 0x2,
             lc3::utils::getBits(state.readPSR(), 10, 8));
-        PIMicroOp callback = std::make_shared<CallbackMicroOp>(CallbackType::EX_ENTER);
-        PIMicroOp func_trace = std::make_shared<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
+        PIMicroOp callback = makePooled<CallbackMicroOp>(CallbackType::EX_ENTER);
+        PIMicroOp func_trace = makePooled<PushFuncTypeMicroOp>(FuncType::EXCEPTION);
 
         msg->insert(dec_pc);
         dec_pc->insert(handle_exception_chain.first);
@@ -345,7 +345,7 @@ void MemWriteRegMicroOp::handleMicroOp(MachineState & state)
 
         next = msg;
     } else {
-        PIMicroOp op = state.writeMem(addr, state.readReg(src_id));
+        PIMicroOp op = state.storeMem(addr, state.readReg(src_id));
 
         if(op) {
             insert(op);
@@ -413,7 +413,7 @@ void BranchMicroOp::handleMicroOp(MachineState & state)
 
 std::string BranchMicroOp::toString(MachineState const & state) const
 {
-    return lc3::utils::ssprintf("uBEN <= (%s):%s", msg.c_str(), pred(state) ? "true" : "false");
+    return lc3::utils::ssprintf("uBEN <= (%s):%s", msg, pred(state) ? "true" : "false");
 }
 
 PIMicroOp BranchMicroOp::insert(PIMicroOp new_next)
@@ -20,7 +20,7 @@ namespace core
     namespace sim { class Decoder; };
     class MachineState;
 
-    class IMicroOp
+    class IMicroOp : public PooledObject
     {
     public:
         IMicroOp(void) : next(nullptr) { }
@@ -291,7 +291,7 @@ namespace core
     public:
         using PredFunction = std::function<bool(MachineState const & state)>;
 
-        BranchMicroOp(PredFunction pred, std::string msg, PIMicroOp true_next, PIMicroOp false_next) :
+        BranchMicroOp(PredFunction pred, char const * msg, PIMicroOp true_next, PIMicroOp false_next) :
             pred(pred), msg(msg), true_next(true_next), false_next(false_next) { }
 
         virtual void handleMicroOp(MachineState & state) override;
@@ -300,7 +300,7 @@ namespace core
 
     private:
         PredFunction pred;
-        std::string msg;
+        char const * msg;
         PIMicroOp true_next, false_next;
     };
 
@@ -362,7 +362,7 @@ namespace core
     class GenericPopMicroOp : public IMicroOp
     {
     public:
-        GenericPopMicroOp(T & data, std::string const & name) : IMicroOp(), data(data), name(name) { }
+        GenericPopMicroOp(T & data, char const * name) : IMicroOp(), data(data), name(name) { }
 
         virtual void handleMicroOp(MachineState & state) override
         {
@@ -373,24 +373,24 @@ namespace core
         virtual std::string toString(MachineState const & state) const override
         {
             (void) state;
-            return lc3::utils::ssprintf("%s <= %s.removeTop()", name.c_str(), name.c_str());
+            return lc3::utils::ssprintf("%s <= %s.removeTop()", name, name);
         }
 
     private:
         T & data;
-        std::string name;
+        char const * name;
     };
 
     class PrintMessageMicroOp : public IMicroOp
     {
     public:
-        PrintMessageMicroOp(std::string const & msg) : IMicroOp(), msg(msg) { }
+        PrintMessageMicroOp(char const * msg) : IMicroOp(), msg(msg) { }
 
         virtual void handleMicroOp(MachineState & state) override;
         virtual std::string toString(MachineState const & state) const override;
 
     private:
-        std::string msg;
+        char const * msg;
     };
 
     bool isAccessViolation(uint16_t addr, MachineState const & state);
@@ -0,0 +1,14 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "watchpoint.h"
+
+std::string lc3::core::watchpointTypeToString(WatchpointType type)
+{
+    switch(type) {
+        case WatchpointType::READ: return "read";
+        case WatchpointType::WRITE: return "write";
+        case WatchpointType::CHANGE: return "change";
+        default: return "unknown";
+    }
+}
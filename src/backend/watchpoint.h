@@ -0,0 +1,38 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef WATCHPOINT_H
+#define WATCHPOINT_H
+
+#include <cstdint>
+#include <string>
+
+namespace lc3
+{
+namespace core
+{
+    enum class WatchpointType
+    {
+          READ
+        , WRITE
+        , CHANGE
+        , INVALID
+    };
+
+    // A single access to a watched address.  For reads, the old and new values are both the value that was read.
+    struct WatchpointHit
+    {
+        WatchpointHit(uint16_t addr, uint16_t old_value, uint16_t new_value, WatchpointType type) :
+            addr(addr), old_value(old_value), new_value(new_value), type(type) { }
+
+        uint16_t addr;
+        uint16_t old_value;
+        uint16_t new_value;
+        WatchpointType type;
+    };
+
+    std::string watchpointTypeToString(WatchpointType type);
+};
+};
+
+#endif
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+#include "asm_gen.h"
+#include "utils.h"
+
+namespace lc3
+{
+namespace bench
+{
+    static constexpr uint32_t FUNC_INSTS = 64;
+    static constexpr uint32_t LABEL_INTERVAL = 4;
+    static constexpr uint32_t DATA_WORDS = 4;
+    static constexpr uint32_t STRING_INTERVAL = 8;
+    static constexpr uint32_t BLKW_INTERVAL = 64;
+    static constexpr uint32_t BLKW_SIZE = 512;
+
+    // A xorshift generator, so that the output does not depend on the standard library's distributions.
+    class Random
+    {
+    public:
+        Random(uint32_t seed) : state(seed == 0 ? 1 : seed) {}
+
+        uint32_t next(uint32_t bound)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state % bound;
+        }
+
+        int32_t range(int32_t low, int32_t high) { return low + static_cast<int32_t>(next(high - low + 1)); }
+
+    private:
+        uint32_t state;
+    };
+
+    static std::string reg(Random & random) { return lc3::utils::ssprintf("R%u", random.next(8)); }
+
+    static std::string mnemonic(Random & random, std::string const & name)
+    {
+        if(random.next(4) != 0) {
+            return name;
+        }
+        std::string ret = name;
+        std::transform(ret.begin(), ret.end(), ret.begin(), ::tolower);
+        return ret;
+    }
+
+    static std::string randomString(Random & random)
+    {
+        static char const chars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 .,:!-";
+        uint32_t len = random.range(120, 250);
+        std::string ret;
+        for(uint32_t i = 0; i < len; i += 1) {
+            if(random.next(40) == 0) {
+                ret += "\\n";
+            } else {
+                ret += chars[random.next(sizeof(chars) - 1)];
+            }
+        }
+        return ret;
+    }
+
+    static std::string instruction(Random & random, uint32_t func, uint32_t num_funcs)
+    {
+        std::string data = lc3::utils::ssprintf("D%u_%u", func, random.next(DATA_WORDS));
+        std::string local = lc3::utils::ssprintf("L%u_%u", func, random.next(FUNC_INSTS / LABEL_INTERVAL));
+
+        switch(random.next(14)) {
+            case 0: return mnemonic(random, "ADD") + " " + reg(random) + ", " + reg(random) + ", " + reg(random);
+            case 1:
+                return mnemonic(random, "ADD") + " " + reg(random) + ", " + reg(random) + ", " +
+                    lc3::utils::ssprintf("#%d", random.range(-16, 15));
+            case 2:
+                return mnemonic(random, "AND") + " " + reg(random) + ", " + reg(random) + ", " +
+                    lc3::utils::ssprintf("x%X", random.next(16));
+            case 3: return mnemonic(random, "NOT") + " " + reg(random) + ", " + reg(random);
+            case 4: return mnemonic(random, "LD") + " " + reg(random) + ", " + data;
+            case 5: return mnemonic(random, "ST") + " " + reg(random) + ", " + data;
+            case 6: return mnemonic(random, "LDI") + " " + reg(random) + ", " + data;
+            case 7: return mnemonic(random, "STI") + " " + reg(random) + ", " + data;
+            case 8:
+                return mnemonic(random, "LDR") + " " + reg(random) + ", R6, " +
+                    lc3::utils::ssprintf("#%d", random.range(-32, 31));
+            case 9:
+                return mnemonic(random, "STR") + " " + reg(random) + ", R6, " +
+                    lc3::utils::ssprintf("#%d", random.range(-32, 31));
+            case 10: return mnemonic(random, "LEA") + " " + reg(random) + ", " + data;
+            case 11: {
+                static char const * const conds[] = { "BR", "BRn", "BRz", "BRp", "BRnz", "BRnp", "BRzp", "BRnzp" };
+                return mnemonic(random, conds[random.next(8)]) + " " + local;
+            }
+            case 12: {
+                // Neighboring functions are always within the 11-bit range of JSR.
+                uint32_t target = func + 1 < num_funcs ? func + 1 : func;
+                if(func > 0 && random.next(2) == 0) {
+                    target = func - 1;
+                }
+                return mnemonic(random, "JSR") + lc3::utils::ssprintf(" F%u", target);
+            }
+            default: {
+                static char const * const traps[] = { "OUT", "PUTS", "GETC", "IN", "TRAP x21", "TRAP x22" };
+                return mnemonic(random, traps[random.next(6)]);
+            }
+        }
+    }
+
+    std::string generateProgram(uint32_t num_insts, uint32_t seed)
+    {
+        Random random(seed);
+        uint32_t num_funcs = std::max(1u, (std::min(num_insts, MAX_GENERATED_INSTS) + FUNC_INSTS - 1) / FUNC_INSTS);
+
+        std::stringstream src;
+        src << "; Synthetic program generated by lc3asmbench\n";
+        src << "        .ORIG x3000\n";
+        src << "MAIN    LD R6, STACK\n";
+        src << "        JSR F0\n";
+        src << "        HALT\n";
+        src << "STACK   .FILL xFD00\n\n";
+
+        for(uint32_t func = 0; func < num_funcs; func += 1) {
+            bool has_string = func % STRING_INTERVAL == 0;
+            src << lc3::utils::ssprintf("; function %u\n", func);
+            src << lc3::utils::ssprintf("F%u\n", func);
+            for(uint32_t i = 0; i < FUNC_INSTS; i += 1) {
+                std::string label = "";
+                if(i % LABEL_INTERVAL == 0) {
+                    label = lc3::utils::ssprintf("L%u_%u", func, i / LABEL_INTERVAL);
+                }
+                std::string line = instruction(random, func, num_funcs);
+                if(has_string && i == 0) {
+                    line = mnemonic(random, "LD") + lc3::utils::ssprintf(" R0, P%u", func);
+                }
+                src << lc3::utils::ssprintf(random.next(2) == 0 ? "%-12s%s" : "%s\t%s", label.c_str(), line.c_str());
+                if(random.next(5) == 0) {
+                    src << "  ; " << random.next(100000);
+                }
+                src << "\n";
+            }
+            src << "        RET\n";
+
+            src << lc3::utils::ssprintf("D%u_0 .FILL #%d\n", func, random.range(-32768, 32767));
+            src << lc3::utils::ssprintf("D%u_1 .FILL x%04X\n", func, random.next(0x10000));
+            src << lc3::utils::ssprintf("D%u_2 .FILL L%u_%u\n", func, func, random.next(FUNC_INSTS / LABEL_INTERVAL));
+            src << lc3::utils::ssprintf("D%u_3 .FILL F%u\n", func, random.next(num_funcs));
+            if(has_string) {
+                src << lc3::utils::ssprintf("P%u .FILL S%u\n", func, func);
+                src << lc3::utils::ssprintf("S%u .STRINGZ \"%s\"\n", func, randomString(random).c_str());
+            }
+            if(func % BLKW_INTERVAL == BLKW_INTERVAL - 1) {
+                src << lc3::utils::ssprintf("B%u .BLKW #%u\n", func, BLKW_SIZE);
+            }
+            src << "\n";
+        }
+
+        src << "        .END\n";
+        return src.str();
+    }
+};
+};
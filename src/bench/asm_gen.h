@@ -0,0 +1,26 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef ASM_GEN_H
+#define ASM_GEN_H
+
+#include <cstdint>
+#include <string>
+
+namespace lc3
+{
+namespace bench
+{
+    // The largest instruction count whose program, data included, still fits between x3000 and the device registers.
+    static constexpr uint32_t MAX_GENERATED_INSTS = 32000;
+
+    // Generates a program with roughly num_insts instructions for benchmarking the assembler.  The program is split
+    // into functions of 64 instructions, each with a label on every fourth instruction, a few words of .FILL data, and
+    // every so often a long .STRINGZ or a large .BLKW.  Every instruction format and most pseudo-ops appear, and the
+    // spelling of mnemonics, the spacing, and the comments vary from line to line.  The same seed always produces the
+    // same program.  The program assembles, but it is not meant to be run.
+    std::string generateProgram(uint32_t num_insts, uint32_t seed);
+};
+};
+
+#endif
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <cctype>
+#include <cstdlib>
+
+#include "json.h"
+
+using namespace lc3::bench;
+
+namespace
+{
+    class Parser
+    {
+    public:
+        Parser(std::string const & text) : text(text), pos(0) {}
+
+        bool parseDocument(JSONValue & value)
+        {
+            if(! parseValue(value)) {
+                return false;
+            }
+            skipSpace();
+            return pos == text.size();
+        }
+
+    private:
+        std::string const & text;
+        std::size_t pos;
+
+        void skipSpace(void)
+        {
+            while(pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+                pos += 1;
+            }
+        }
+
+        bool consume(char c)
+        {
+            skipSpace();
+            if(pos < text.size() && text[pos] == c) {
+                pos += 1;
+                return true;
+            }
+            return false;
+        }
+
+        bool consumeWord(std::string const & word)
+        {
+            if(text.compare(pos, word.size(), word) == 0) {
+                pos += word.size();
+                return true;
+            }
+            return false;
+        }
+
+        bool parseValue(JSONValue & value)
+        {
+            skipSpace();
+            if(pos >= text.size()) {
+                return false;
+            }
+
+            char c = text[pos];
+            if(c == '{') {
+                value.type = JSONValue::Type::OBJECT;
+                return parseObject(value);
+            } else if(c == '[') {
+                value.type = JSONValue::Type::ARRAY;
+                return parseArray(value);
+            } else if(c == '"') {
+                value.type = JSONValue::Type::STRING;
+                return parseString(value.string);
+            } else if(consumeWord("true")) {
+                value.type = JSONValue::Type::BOOL;
+                value.boolean = true;
+                return true;
+            } else if(consumeWord("false")) {
+                value.type = JSONValue::Type::BOOL;
+                value.boolean = false;
+                return true;
+            } else if(consumeWord("null")) {
+                value.type = JSONValue::Type::NUL;
+                return true;
+            }
+
+            value.type = JSONValue::Type::NUMBER;
+            return parseNumber(value.number);
+        }
+
+        bool parseObject(JSONValue & value)
+        {
+            pos += 1;
+            if(consume('}')) {
+                return true;
+            }
+
+            do {
+                std::pair<std::string, JSONValue> member;
+                skipSpace();
+                if(! parseString(member.first) || ! consume(':') || ! parseValue(member.second)) {
+                    return false;
+                }
+                value.members.push_back(member);
+            } while(consume(','));
+
+            return consume('}');
+        }
+
+        bool parseArray(JSONValue & value)
+        {
+            pos += 1;
+            if(consume(']')) {
+                return true;
+            }
+
+            do {
+                JSONValue element;
+                if(! parseValue(element)) {
+                    return false;
+                }
+                value.array.push_back(element);
+            } while(consume(','));
+
+            return consume(']');
+        }
+
+        // Escapes other than \uXXXX are decoded.  \uXXXX is kept as is, since result files only use it for control
+        // characters.
+        bool parseString(std::string & result)
+        {
+            if(pos >= text.size() || text[pos] != '"') {
+                return false;
+            }
+            pos += 1;
+
+            while(pos < text.size() && text[pos] != '"') {
+                char c = text[pos];
+                pos += 1;
+                if(c != '\\') {
+                    result += c;
+                    continue;
+                }
+
+                if(pos >= text.size()) {
+                    return false;
+                }
+                char escape = text[pos];
+                pos += 1;
+                switch(escape) {
+                    case 'n': result += '\n'; break;
+                    case 't': result += '\t'; break;
+                    case 'r': result += '\r'; break;
+                    case 'b': result += '\b'; break;
+                    case 'f': result += '\f'; break;
+                    case 'u': result += "\\u"; break;
+                    default: result += escape; break;
+                }
+            }
+
+            if(pos >= text.size()) {
+                return false;
+            }
+            pos += 1;
+            return true;
+        }
+
+        bool parseNumber(double & result)
+        {
+            char const * start = text.c_str() + pos;
+            char * end = nullptr;
+            result = std::strtod(start, &end);
+            if(end == start) {
+                return false;
+            }
+            pos += end - start;
+            return true;
+        }
+    };
+};
+
+JSONValue const * JSONValue::get(std::string const & key) const
+{
+    for(std::pair<std::string, JSONValue> const & member : members) {
+        if(member.first == key) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+bool lc3::bench::parseJSON(std::string const & text, JSONValue & value)
+{
+    Parser parser(text);
+    return parser.parseDocument(value);
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lc3
+{
+namespace bench
+{
+    // Just enough of a JSON reader to load the result files that lc3bench writes.
+    struct JSONValue
+    {
+        enum class Type {
+              NUL = 0
+            , BOOL
+            , NUMBER
+            , STRING
+            , ARRAY
+            , OBJECT
+        };
+
+        Type type = Type::NUL;
+        bool boolean = false;
+        double number = 0;
+        std::string string;
+        std::vector<JSONValue> array;
+        std::vector<std::pair<std::string, JSONValue>> members;
+
+        // Member with the given key, or nullptr if this is not an object or has no such member.
+        JSONValue const * get(std::string const & key) const;
+    };
+
+    // Returns false if text is not a single well-formed JSON value.
+    bool parseJSON(std::string const & text, JSONValue & value);
+};
+};
+
+#endif
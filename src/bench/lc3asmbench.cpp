@@ -0,0 +1,280 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+// Times each phase of the assembler, and loading the result into a simulator, on generated programs of increasing
+// size, and reports the results as JSON.
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "asm_gen.h"
+#include "assembler.h"
+#include "common.h"
+#include "inputter.h"
+#include "simulator.h"
+
+struct Phase
+{
+    char const * name;
+    double lc3::core::AssemblerTimings::* seconds;
+};
+
+static Phase const phases[] = {
+      { "tokenize", &lc3::core::AssemblerTimings::tokenize }
+    , { "build_statements", &lc3::core::AssemblerTimings::build_statements }
+    , { "mark_pcs", &lc3::core::AssemblerTimings::mark_pcs }
+    , { "symbol_table", &lc3::core::AssemblerTimings::symbol_table }
+    , { "encode", &lc3::core::AssemblerTimings::encode }
+    , { "serialize", &lc3::core::AssemblerTimings::serialize }
+};
+
+struct Result
+{
+    uint32_t size;
+    uint64_t lines;
+    uint64_t bytes;
+    uint64_t labels;
+    uint64_t words;
+    lc3::core::AssemblerTimings timings;
+    double load;
+};
+
+struct CLIArgs
+{
+    std::string output_file = "";
+    std::string generate_file = "";
+    uint32_t repeat = 3;
+    uint32_t seed = 1;
+    std::vector<uint32_t> sizes;
+    double max_growth = 3;
+};
+
+static bool runSize(CLIArgs const & args, uint32_t size, Result & result);
+static double getTotal(lc3::core::AssemblerTimings const & timings);
+static uint32_t checkScaling(std::vector<Result> const & results, double max_growth);
+static std::string toJSON(CLIArgs const & args, std::vector<Result> const & results);
+
+int main(int argc, char * argv[])
+{
+    CLIArgs args;
+    std::vector<std::pair<std::string, std::string>> parsed_args = parseCLIArgs(argc, argv);
+    for(auto const & arg : parsed_args) {
+        if(std::get<0>(arg) == "output") {
+            args.output_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "generate") {
+            args.generate_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "repeat") {
+            args.repeat = std::max(1, std::stoi(std::get<1>(arg)));
+        } else if(std::get<0>(arg) == "seed") {
+            args.seed = static_cast<uint32_t>(std::stoul(std::get<1>(arg)));
+        } else if(std::get<0>(arg) == "size") {
+            args.sizes.push_back(static_cast<uint32_t>(std::stoul(std::get<1>(arg))));
+        } else if(std::get<0>(arg) == "max-growth") {
+            args.max_growth = std::stod(std::get<1>(arg));
+        } else if(std::get<0>(arg) == "h" || std::get<0>(arg) == "help") {
+            std::cout << "usage: " << argv[0] << " [OPTIONS]\n";
+            std::cout << "\n";
+            std::cout << "  -h,--help              Print this message\n";
+            std::cout << "  --output=file          Write results to file instead of stdout\n";
+            std::cout << "  --repeat=N             Assemble and load each program N times and report the fastest\n";
+            std::cout << "  --size=N               Generate a program with N instructions (can be repeated)\n";
+            std::cout << "  --seed=N               Seed for the program generator\n";
+            std::cout << "  --generate=file        Write the generated program to file instead of benchmarking\n";
+            std::cout << "  --max-growth=F         Largest allowed growth in time per line from the smallest to the\n";
+            std::cout << "                         largest program before a phase is reported as superlinear\n";
+            return 0;
+        }
+    }
+
+    if(args.sizes.empty()) {
+        args.sizes = { 1000, 8000, lc3::bench::MAX_GENERATED_INSTS };
+    }
+    for(uint32_t size : args.sizes) {
+        if(size == 0 || size > lc3::bench::MAX_GENERATED_INSTS) {
+            std::cerr << "size must be between 1 and " << lc3::bench::MAX_GENERATED_INSTS << "\n";
+            return 1;
+        }
+    }
+    std::sort(args.sizes.begin(), args.sizes.end());
+
+    if(args.generate_file != "") {
+        std::ofstream output(args.generate_file);
+        if(! output) {
+            std::cerr << "could not open file " << args.generate_file << "\n";
+            return 1;
+        }
+        output << lc3::bench::generateProgram(args.sizes.back(), args.seed);
+        return 0;
+    }
+
+    std::vector<Result> results;
+    for(uint32_t size : args.sizes) {
+        Result result;
+        if(! runSize(args, size, result)) {
+            std::cerr << "generated program with " << size << " instructions did not assemble\n";
+            return 1;
+        }
+
+        double assemble = getTotal(result.timings);
+        std::cerr << lc3::utils::ssprintf("%6u insts %7llu lines %9.3f ms assemble %8.1f ns/line %9.3f ms load\n",
+            size, static_cast<unsigned long long>(result.lines), assemble * 1e3, assemble * 1e9 / result.lines,
+            result.load * 1e3);
+        results.push_back(result);
+    }
+
+    uint32_t superlinear = checkScaling(results, args.max_growth);
+
+    std::string json = toJSON(args, results);
+    if(args.output_file != "") {
+        std::ofstream output(args.output_file);
+        if(! output) {
+            std::cerr << "could not open file " << args.output_file << "\n";
+            return 1;
+        }
+        output << json;
+    } else {
+        std::cout << json;
+    }
+
+    return superlinear == 0 ? 0 : 1;
+}
+
+static bool runSize(CLIArgs const & args, uint32_t size, Result & result)
+{
+    std::string src = lc3::bench::generateProgram(size, args.seed);
+    result.size = size;
+    result.lines = std::count(src.begin(), src.end(), '\n');
+    result.bytes = src.size();
+
+    lc3::utils::NullPrinter printer;
+    std::string obj;
+    for(uint32_t i = 0; i < args.repeat; i += 1) {
+        lc3::core::Assembler assembler(printer, 0, false);
+        std::stringstream src_buffer(src);
+        std::pair<std::shared_ptr<std::stringstream>, lc3::core::SymbolTable> asm_res;
+        try {
+            asm_res = assembler.assemble(src_buffer);
+        } catch(lc3::utils::exception const & e) {
+            (void) e;
+            return false;
+        }
+
+        // Keep the fastest time of each phase separately, since noise in one phase says nothing about the others.
+        for(Phase const & phase : phases) {
+            double seconds = assembler.getTimings().*phase.seconds;
+            if(i == 0 || seconds < result.timings.*phase.seconds) {
+                result.timings.*phase.seconds = seconds;
+            }
+        }
+        result.labels = asm_res.second.size();
+        obj = asm_res.first->str();
+    }
+
+    std::size_t header_size = lc3::utils::getMagicHeader().size() + lc3::utils::getVersionString().size();
+    std::stringstream obj_buffer(obj.substr(header_size));
+    result.words = 0;
+    while(! obj_buffer.eof()) {
+        lc3::core::MemLocation mem;
+        obj_buffer >> mem;
+        if(obj_buffer.eof()) {
+            break;
+        }
+        if(! mem.isOrig()) {
+            result.words += 1;
+        }
+    }
+
+    for(uint32_t i = 0; i < args.repeat; i += 1) {
+        lc3::utils::NullInputter inputter;
+        lc3::core::Simulator simulator(printer, inputter, 0);
+        std::stringstream load_buffer(obj, std::ios_base::in | std::ios_base::binary);
+
+        auto start = std::chrono::steady_clock::now();
+        simulator.loadObj("bench", load_buffer);
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if(i == 0 || seconds < result.load) {
+            result.load = seconds;
+        }
+    }
+
+    return true;
+}
+
+static double getTotal(lc3::core::AssemblerTimings const & timings)
+{
+    double total = 0;
+    for(Phase const & phase : phases) {
+        total += timings.*phase.seconds;
+    }
+    return total;
+}
+
+// Compares the time per line of each phase on the largest program against the smallest.  A linear phase stays about
+// the same, so growth well beyond that points to quadratic behavior.  Phases that take under a millisecond on the
+// largest program are too short to judge.
+static uint32_t checkScaling(std::vector<Result> const & results, double max_growth)
+{
+    if(results.size() < 2) {
+        return 0;
+    }
+
+    Result const & small = results.front();
+    Result const & large = results.back();
+    uint32_t superlinear = 0;
+    for(Phase const & phase : phases) {
+        double small_per_line = small.timings.*phase.seconds / small.lines;
+        double large_per_line = large.timings.*phase.seconds / large.lines;
+        if(large.timings.*phase.seconds < 1e-3 || small_per_line <= 0) {
+            continue;
+        }
+
+        double growth = large_per_line / small_per_line;
+        if(growth > max_growth) {
+            std::cerr << lc3::utils::ssprintf("SUPERLINEAR: %s takes %.1fx as long per line at %u instructions as at "
+                "%u\n", phase.name, growth, large.size, small.size);
+            superlinear += 1;
+        }
+    }
+    return superlinear;
+}
+
+static std::string toJSON(CLIArgs const & args, std::vector<Result> const & results)
+{
+    std::stringstream json;
+    json << "{\n";
+    json << "  \"version\": 1,\n";
+    json << "  \"seed\": " << args.seed << ",\n";
+    json << "  \"repeat\": " << args.repeat << ",\n";
+    json << "  \"results\": [";
+    for(std::size_t i = 0; i < results.size(); i += 1) {
+        Result const & result = results[i];
+        double assemble = getTotal(result.timings);
+        json << (i == 0 ? "\n" : ",\n");
+        json << "    {\n";
+        json << "      \"instructions\": " << result.size << ",\n";
+        json << "      \"lines\": " << result.lines << ",\n";
+        json << "      \"bytes\": " << result.bytes << ",\n";
+        json << "      \"labels\": " << result.labels << ",\n";
+        json << "      \"words\": " << result.words << ",\n";
+        json << "      \"phases\": {\n";
+        for(std::size_t j = 0; j < sizeof(phases) / sizeof(phases[0]); j += 1) {
+            json << lc3::utils::ssprintf("        \"%s\": %.6f%s\n", phases[j].name, result.timings.*phases[j].seconds,
+                j + 1 == sizeof(phases) / sizeof(phases[0]) ? "" : ",");
+        }
+        json << "      },\n";
+        json << lc3::utils::ssprintf("      \"assemble_seconds\": %.6f,\n", assemble);
+        json << lc3::utils::ssprintf("      \"ns_per_line\": %.3f,\n", assemble * 1e9 / result.lines);
+        json << lc3::utils::ssprintf("      \"load_seconds\": %.6f,\n", result.load);
+        json << lc3::utils::ssprintf("      \"load_ns_per_word\": %.3f\n", result.load * 1e9 / result.words);
+        json << "    }";
+    }
+    json << "\n  ]\n";
+    json << "}\n";
+    return json.str();
+}
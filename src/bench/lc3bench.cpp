@@ -0,0 +1,573 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+// Runs the benchmark corpus under each engine and reports throughput, allocations, and memory use as JSON, or compares
+// two such reports.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define API_VER 2
+#include "assembler.h"
+#include "common.h"
+#include "device_regs.h"
+#include "interface.h"
+#include "jit.h"
+#include "json.h"
+#include "workloads.h"
+
+// Every allocation in the process is counted by replacing the global allocation functions.  Each block carries its
+// size in a header so that the live and peak heap sizes can be tracked as well.
+namespace
+{
+    constexpr std::size_t ALLOC_HEADER = alignof(std::max_align_t);
+
+    std::atomic<uint64_t> alloc_count(0);
+    std::atomic<uint64_t> live_heap_bytes(0);
+    std::atomic<uint64_t> peak_heap_bytes(0);
+
+    void * allocate(std::size_t size)
+    {
+        char * block = static_cast<char *>(std::malloc(size + ALLOC_HEADER));
+        if(block == nullptr) {
+            return nullptr;
+        }
+        *reinterpret_cast<std::size_t *>(block) = size;
+
+        alloc_count.fetch_add(1, std::memory_order_relaxed);
+        uint64_t live = live_heap_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+        uint64_t peak = peak_heap_bytes.load(std::memory_order_relaxed);
+        while(live > peak && ! peak_heap_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+
+        return block + ALLOC_HEADER;
+    }
+
+    void deallocate(void * ptr)
+    {
+        if(ptr == nullptr) {
+            return;
+        }
+        char * block = static_cast<char *>(ptr) - ALLOC_HEADER;
+        live_heap_bytes.fetch_sub(*reinterpret_cast<std::size_t *>(block), std::memory_order_relaxed);
+        std::free(block);
+    }
+};
+
+void * operator new(std::size_t size)
+{
+    void * ptr = allocate(size);
+    if(ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void * operator new[](std::size_t size) { return operator new(size); }
+void * operator new(std::size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+void * operator new[](std::size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+void operator delete(void * ptr) noexcept { deallocate(ptr); }
+void operator delete[](void * ptr) noexcept { deallocate(ptr); }
+void operator delete(void * ptr, std::nothrow_t const &) noexcept { deallocate(ptr); }
+void operator delete[](void * ptr, std::nothrow_t const &) noexcept { deallocate(ptr); }
+
+static constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+// Discards program output, keeping only its size and a hash of it.
+class CountingPrinter : public lc3::utils::IPrinter
+{
+public:
+    CountingPrinter(void) : bytes(0), hash(FNV_OFFSET) {}
+
+    virtual void setColor(lc3::utils::PrintColor color) override { (void) color; }
+    virtual void print(std::string const & string) override
+    {
+        for(char c : string) {
+            add(c);
+        }
+    }
+    virtual void newline(void) override { add('\n'); }
+
+    uint64_t getBytes(void) const { return bytes; }
+    uint64_t getHash(void) const { return hash; }
+
+private:
+    uint64_t bytes;
+    uint64_t hash;
+
+    void add(char c)
+    {
+        bytes += 1;
+        hash = (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+    }
+};
+
+// Supplies the same input over and over, one character every delay polls.
+class RepeatingInputter : public lc3::utils::IInputter
+{
+public:
+    RepeatingInputter(std::string const & input, uint32_t delay) : input(input), delay(delay), pos(0), polls(0) {}
+
+    virtual void beginInput(void) override {}
+    virtual bool getChar(char & c) override
+    {
+        if(input.empty()) {
+            return false;
+        }
+        polls += 1;
+        if(polls < delay) {
+            return false;
+        }
+        polls = 0;
+        c = input[pos];
+        pos = (pos + 1) % input.size();
+        return true;
+    }
+    virtual void endInput(void) override {}
+    virtual bool hasRemaining(void) const override { return ! input.empty(); }
+    virtual uint64_t getIdleCalls(void) const override
+    {
+        if(input.empty()) {
+            return std::numeric_limits<uint64_t>::max();
+        }
+        return polls + 1 < delay ? delay - 1 - polls : 0;
+    }
+    virtual void skipIdleCalls(uint64_t count) override { polls += static_cast<uint32_t>(count); }
+
+private:
+    std::string input;
+    uint32_t delay;
+    std::size_t pos;
+    uint32_t polls;
+};
+
+struct Mode
+{
+    std::string name;
+    lc3::core::EngineType engine;
+};
+
+struct Program
+{
+    lc3::bench::Workload const * workload;
+    std::vector<lc3::core::MemLocation> image;
+    uint16_t iters_addr;
+    uint16_t default_iters;
+};
+
+struct Result
+{
+    std::string workload;
+    std::string mode;
+    uint16_t iters;
+    uint64_t instructions;
+    double seconds;
+    uint64_t allocations;
+    uint64_t peak_heap_bytes;
+    uint64_t checksum;
+};
+
+struct CLIArgs
+{
+    std::string output_file = "";
+    uint32_t repeat = 3;
+    double scale = 1;
+    std::vector<std::string> workload_filter;
+    std::vector<std::string> mode_filter;
+    bool list = false;
+    bool compare = false;
+    double threshold = 5;
+};
+
+static bool prepareProgram(lc3::bench::Workload const & workload, Program & program);
+static bool runOnce(Program const & program, Mode const & mode, double scale, Result & result);
+static std::string toJSON(CLIArgs const & args, std::vector<Result> const & results);
+static int compareResults(std::string const & base_file, std::string const & new_file, double threshold);
+static bool contains(std::vector<std::string> const & filter, std::string const & name);
+
+int main(int argc, char * argv[])
+{
+    CLIArgs args;
+    std::vector<std::pair<std::string, std::string>> parsed_args = parseCLIArgs(argc, argv);
+    for(auto const & arg : parsed_args) {
+        if(std::get<0>(arg) == "output") {
+            args.output_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "repeat") {
+            args.repeat = std::max(1, std::stoi(std::get<1>(arg)));
+        } else if(std::get<0>(arg) == "scale") {
+            args.scale = std::stod(std::get<1>(arg));
+        } else if(std::get<0>(arg) == "workload") {
+            args.workload_filter.push_back(std::get<1>(arg));
+        } else if(std::get<0>(arg) == "mode") {
+            args.mode_filter.push_back(std::get<1>(arg));
+        } else if(std::get<0>(arg) == "list") {
+            args.list = true;
+        } else if(std::get<0>(arg) == "compare") {
+            args.compare = true;
+        } else if(std::get<0>(arg) == "threshold") {
+            args.threshold = std::stod(std::get<1>(arg));
+        } else if(std::get<0>(arg) == "h" || std::get<0>(arg) == "help") {
+            std::cout << "usage: " << argv[0] << " [OPTIONS]\n";
+            std::cout << "       " << argv[0] << " --compare [--threshold=P] BASE NEW\n";
+            std::cout << "\n";
+            std::cout << "  -h,--help              Print this message\n";
+            std::cout << "  --output=file          Write results to file instead of stdout\n";
+            std::cout << "  --repeat=N             Run each workload N times per mode and report the fastest\n";
+            std::cout << "  --scale=F              Multiply the iterations of every workload by F\n";
+            std::cout << "  --workload=NAME        Only run workload NAME (can be repeated)\n";
+            std::cout << "  --mode=MODE            Only run mode MODE: detailed, fast, or jit (can be repeated)\n";
+            std::cout << "  --list                 List the workloads\n";
+            std::cout << "  --compare              Compare the result files BASE and NEW\n";
+            std::cout << "  --threshold=P          Percent change in ns/inst or allocs/inst reported as a regression\n";
+            return 0;
+        }
+    }
+
+    if(args.compare) {
+        std::vector<std::string> files;
+        for(int i = 1; i < argc; i += 1) {
+            if(argv[i][0] != '-') {
+                files.push_back(argv[i]);
+            }
+        }
+        if(files.size() != 2) {
+            std::cerr << "--compare needs two result files\n";
+            return 1;
+        }
+        return compareResults(files[0], files[1], args.threshold);
+    }
+
+    if(args.list) {
+        for(lc3::bench::Workload const & workload : lc3::bench::getWorkloads()) {
+            std::cout << lc3::utils::ssprintf("%-12s %s\n", workload.name.c_str(), workload.description.c_str());
+        }
+        return 0;
+    }
+
+    std::vector<Mode> modes;
+    for(Mode const & mode : std::vector<Mode>{ { "detailed", lc3::core::EngineType::DETAILED },
+        { "fast", lc3::core::EngineType::FAST }, { "jit", lc3::core::EngineType::JIT } })
+    {
+        if(mode.engine == lc3::core::EngineType::JIT && ! lc3::core::sim::JIT::isSupported()) {
+            continue;
+        }
+        if(args.mode_filter.empty() || contains(args.mode_filter, mode.name)) {
+            modes.push_back(mode);
+        }
+    }
+
+    std::vector<Result> results;
+    bool mismatch = false;
+    for(lc3::bench::Workload const & workload : lc3::bench::getWorkloads()) {
+        if(! args.workload_filter.empty() && ! contains(args.workload_filter, workload.name)) {
+            continue;
+        }
+
+        Program program;
+        if(! prepareProgram(workload, program)) {
+            std::cerr << "could not assemble workload " << workload.name << "\n";
+            return 1;
+        }
+
+        std::size_t first_result = results.size();
+        for(Mode const & mode : modes) {
+            Result best;
+            for(uint32_t i = 0; i < args.repeat; i += 1) {
+                Result result;
+                if(! runOnce(program, mode, args.scale, result)) {
+                    std::cerr << "workload " << workload.name << " did not reach HALT in mode " << mode.name << "\n";
+                    return 1;
+                }
+                if(i == 0 || result.seconds < best.seconds) {
+                    best = result;
+                }
+            }
+
+            double ns_per_inst = best.seconds * 1e9 / best.instructions;
+            std::cerr << lc3::utils::ssprintf("%-12s %-9s %10llu insts %9.2f MIPS %9.2f ns/inst %8.4f allocs/inst\n",
+                best.workload.c_str(), best.mode.c_str(), static_cast<unsigned long long>(best.instructions),
+                best.instructions / best.seconds / 1e6, ns_per_inst,
+                static_cast<double>(best.allocations) / best.instructions);
+            results.push_back(best);
+        }
+
+        // Every engine must leave the program in the same state.
+        for(std::size_t i = first_result + 1; i < results.size(); i += 1) {
+            Result const & expected = results[first_result];
+            if(results[i].checksum != expected.checksum) {
+                std::cerr << lc3::utils::ssprintf("workload %s: checksum %016llx in mode %s does not match %016llx in "
+                    "mode %s\n", workload.name.c_str(), static_cast<unsigned long long>(results[i].checksum),
+                    results[i].mode.c_str(), static_cast<unsigned long long>(expected.checksum),
+                    expected.mode.c_str());
+                mismatch = true;
+            }
+        }
+    }
+
+    std::string json = toJSON(args, results);
+    if(args.output_file != "") {
+        std::ofstream output(args.output_file);
+        if(! output) {
+            std::cerr << "could not open file " << args.output_file << "\n";
+            return 1;
+        }
+        output << json;
+    } else {
+        std::cout << json;
+    }
+
+    return mismatch ? 1 : 0;
+}
+
+static bool prepareProgram(lc3::bench::Workload const & workload, Program & program)
+{
+    CountingPrinter printer;
+    lc3::core::Assembler assembler(printer, 0, false);
+    assembler.setFilename(workload.name);
+
+    std::stringstream src(workload.src);
+    std::pair<std::shared_ptr<std::stringstream>, lc3::core::SymbolTable> asm_res;
+    try {
+        asm_res = assembler.assemble(src);
+    } catch(lc3::utils::exception const & e) {
+        (void) e;
+        return false;
+    }
+
+    auto search = asm_res.second.find("iters");
+    if(search == asm_res.second.end()) {
+        return false;
+    }
+
+    std::stringstream & obj = *asm_res.first;
+    std::string header_and_version = lc3::utils::getMagicHeader() + lc3::utils::getVersionString();
+    obj.seekg(header_and_version.size());
+
+    program.workload = &workload;
+    program.iters_addr = static_cast<uint16_t>(search->second);
+    program.default_iters = 0;
+
+    uint16_t addr = 0;
+    while(! obj.eof()) {
+        lc3::core::MemLocation mem;
+        obj >> mem;
+        if(obj.eof()) {
+            break;
+        }
+
+        if(mem.isOrig()) {
+            addr = mem.getValue();
+        } else {
+            if(addr == program.iters_addr) {
+                program.default_iters = mem.getValue();
+            }
+            addr += 1;
+        }
+        program.image.push_back(mem);
+    }
+
+    return true;
+}
+
+static bool runOnce(Program const & program, Mode const & mode, double scale, Result & result)
+{
+    lc3::bench::Workload const & workload = *program.workload;
+
+    CountingPrinter printer;
+    RepeatingInputter inputter(workload.input, workload.input_delay);
+    lc3::sim simulator(printer, inputter, 1);
+    simulator.setEngineType(mode.engine);
+
+    uint16_t addr = 0;
+    for(lc3::core::MemLocation const & mem : program.image) {
+        if(mem.isOrig()) {
+            addr = mem.getValue();
+        } else {
+            simulator.writeMem(addr, mem.getValue());
+            simulator.setMemLine(addr, mem.getLine());
+            addr += 1;
+        }
+    }
+
+    double iters = std::round(program.default_iters * scale);
+    result.iters = static_cast<uint16_t>(std::min(std::max(iters, 1.0), 65535.0));
+    simulator.writeMem(program.iters_addr, result.iters);
+    simulator.writePC(0x3000);
+    if(workload.keyboard_interrupts) {
+        simulator.writeMem(KBSR, 0x4000);
+    }
+
+    uint64_t start_count = simulator.getInstExecCount();
+    uint64_t start_allocs = alloc_count.load();
+    uint64_t start_heap = live_heap_bytes.load();
+    peak_heap_bytes.store(start_heap);
+
+    auto start = std::chrono::steady_clock::now();
+    bool success = simulator.runUntilHalt();
+    auto end = std::chrono::steady_clock::now();
+
+    result.workload = workload.name;
+    result.mode = mode.name;
+    result.instructions = simulator.getInstExecCount() - start_count;
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.allocations = alloc_count.load() - start_allocs;
+    result.peak_heap_bytes = peak_heap_bytes.load() - start_heap;
+
+    // The checksum covers everything the program can affect, so that the modes can be checked against each other.
+    uint64_t hash = FNV_OFFSET;
+    for(uint16_t reg = 0; reg < 8; reg += 1) {
+        hash = (hash ^ simulator.readReg(reg)) * FNV_PRIME;
+    }
+    for(uint32_t addr = USER_START; addr < USER_END; addr += 1) {
+        hash = (hash ^ simulator.readMem(static_cast<uint16_t>(addr))) * FNV_PRIME;
+    }
+    hash = (hash ^ printer.getBytes()) * FNV_PRIME;
+    result.checksum = (hash ^ printer.getHash()) * FNV_PRIME;
+
+    return success && result.instructions != 0 && simulator.readMem(simulator.readPC()) == 0xF025;
+}
+
+static std::string toJSON(CLIArgs const & args, std::vector<Result> const & results)
+{
+    std::stringstream json;
+    json << "{\n";
+    json << "  \"version\": 1,\n";
+    json << lc3::utils::ssprintf("  \"scale\": %g,\n", args.scale);
+    json << "  \"repeat\": " << args.repeat << ",\n";
+    // The resident set size only ever grows over the life of the process, so it is reported once for all of the runs.
+    json << "  \"peak_rss_bytes\": " << getPeakRSS() << ",\n";
+    json << "  \"results\": [";
+    for(std::size_t i = 0; i < results.size(); i += 1) {
+        Result const & result = results[i];
+        json << (i == 0 ? "\n" : ",\n");
+        json << "    {\n";
+        json << "      \"workload\": \"" << result.workload << "\",\n";
+        json << "      \"mode\": \"" << result.mode << "\",\n";
+        json << "      \"iterations\": " << result.iters << ",\n";
+        json << "      \"instructions\": " << result.instructions << ",\n";
+        json << lc3::utils::ssprintf("      \"seconds\": %.6f,\n", result.seconds);
+        json << lc3::utils::ssprintf("      \"inst_per_sec\": %.0f,\n", result.instructions / result.seconds);
+        json << lc3::utils::ssprintf("      \"ns_per_inst\": %.3f,\n", result.seconds * 1e9 / result.instructions);
+        json << lc3::utils::ssprintf("      \"allocs_per_inst\": %.6f,\n",
+            static_cast<double>(result.allocations) / result.instructions);
+        json << "      \"peak_heap_bytes\": " << result.peak_heap_bytes << ",\n";
+        json << lc3::utils::ssprintf("      \"checksum\": \"%016llx\"\n",
+            static_cast<unsigned long long>(result.checksum));
+        json << "    }";
+    }
+    json << "\n  ]\n";
+    json << "}\n";
+    return json.str();
+}
+
+static bool loadResults(std::string const & filename, std::map<std::string, lc3::bench::JSONValue> & results)
+{
+    std::ifstream input(filename);
+    if(! input) {
+        std::cerr << "could not open file " << filename << "\n";
+        return false;
+    }
+    std::stringstream text;
+    text << input.rdbuf();
+
+    lc3::bench::JSONValue root;
+    lc3::bench::JSONValue const * entries = nullptr;
+    if(lc3::bench::parseJSON(text.str(), root)) {
+        entries = root.get("results");
+    }
+    if(entries == nullptr || entries->type != lc3::bench::JSONValue::Type::ARRAY) {
+        std::cerr << filename << " is not an lc3bench result file\n";
+        return false;
+    }
+
+    for(lc3::bench::JSONValue const & entry : entries->array) {
+        lc3::bench::JSONValue const * workload = entry.get("workload");
+        lc3::bench::JSONValue const * mode = entry.get("mode");
+        if(workload != nullptr && mode != nullptr) {
+            results[workload->string + "/" + mode->string] = entry;
+        }
+    }
+    return true;
+}
+
+static double getNumber(lc3::bench::JSONValue const & entry, std::string const & key)
+{
+    lc3::bench::JSONValue const * value = entry.get(key);
+    return value != nullptr ? value->number : 0;
+}
+
+static std::string getString(lc3::bench::JSONValue const & entry, std::string const & key)
+{
+    lc3::bench::JSONValue const * value = entry.get(key);
+    return value != nullptr ? value->string : "";
+}
+
+static int compareResults(std::string const & base_file, std::string const & new_file, double threshold)
+{
+    std::map<std::string, lc3::bench::JSONValue> base_results, new_results;
+    if(! loadResults(base_file, base_results) || ! loadResults(new_file, new_results)) {
+        return 1;
+    }
+
+    uint32_t regressions = 0;
+    std::cout << lc3::utils::ssprintf("%-22s %12s %12s %8s %12s %12s  %s\n", "workload/mode", "base ns/inst",
+        "new ns/inst", "change", "base allocs", "new allocs", "status");
+    for(auto const & new_entry : new_results) {
+        auto base_search = base_results.find(new_entry.first);
+        if(base_search == base_results.end()) {
+            std::cout << lc3::utils::ssprintf("%-22s %s\n", new_entry.first.c_str(), "not in base");
+            continue;
+        }
+
+        lc3::bench::JSONValue const & base = base_search->second;
+        lc3::bench::JSONValue const & cur = new_entry.second;
+        double base_ns = getNumber(base, "ns_per_inst");
+        double new_ns = getNumber(cur, "ns_per_inst");
+        double base_allocs = getNumber(base, "allocs_per_inst");
+        double new_allocs = getNumber(cur, "allocs_per_inst");
+        double change = base_ns > 0 ? (new_ns - base_ns) / base_ns * 100 : 0;
+
+        std::string status = "ok";
+        if(getNumber(base, "iterations") == getNumber(cur, "iterations") &&
+            getString(base, "checksum") != getString(cur, "checksum"))
+        {
+            status = "MISMATCH";
+        } else if(change > threshold) {
+            status = "REGRESSION";
+        } else if(new_allocs > base_allocs * (1 + threshold / 100) + 1e-6) {
+            status = "ALLOC REGRESSION";
+        } else if(change < -threshold) {
+            status = "improved";
+        }
+        if(status != "ok" && status != "improved") {
+            regressions += 1;
+        }
+
+        std::cout << lc3::utils::ssprintf("%-22s %12.3f %12.3f %+7.1f%% %12.6f %12.6f  %s\n", new_entry.first.c_str(),
+            base_ns, new_ns, change, base_allocs, new_allocs, status.c_str());
+    }
+    for(auto const & base_entry : base_results) {
+        if(new_results.find(base_entry.first) == new_results.end()) {
+            std::cout << lc3::utils::ssprintf("%-22s %s\n", base_entry.first.c_str(), "not in new");
+        }
+    }
+
+    std::cout << regressions << " regression(s) beyond " << threshold << "%\n";
+    return regressions == 0 ? 0 : 1;
+}
+
+static bool contains(std::vector<std::string> const & filter, std::string const & name)
+{
+    return std::find(filter.begin(), filter.end(), name) != filter.end();
+}
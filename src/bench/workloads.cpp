@@ -0,0 +1,309 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include "workloads.h"
+
+namespace lc3
+{
+namespace bench
+{
+    // Shift-and-add multiplication folded into an accumulator with XOR, built from NOT and AND.
+    static char const * alu_src = R"ALU(
+        .ORIG x3000
+        LD   R5, ITERS
+        AND  R4, R4, #0
+OUTER   LD   R1, SEED
+        ADD  R2, R5, #0
+        AND  R3, R3, #0
+        AND  R6, R6, #0
+        ADD  R6, R6, #1
+MULT    AND  R0, R2, R6
+        BRz  SKIP
+        ADD  R3, R3, R1
+SKIP    ADD  R1, R1, R1
+        ADD  R6, R6, R6
+        BRnp MULT
+        NOT  R0, R3
+        AND  R0, R4, R0
+        NOT  R1, R4
+        AND  R1, R1, R3
+        NOT  R0, R0
+        NOT  R1, R1
+        AND  R0, R0, R1
+        NOT  R4, R0
+        ADD  R5, R5, #-1
+        BRnp OUTER
+        ST   R4, RESULT
+        HALT
+ITERS   .FILL #5000
+SEED    .FILL x2F1B
+RESULT  .BLKW 1
+        .END
+)ALU";
+
+    // Fills an array from a linear congruential generator and insertion sorts it, once per iteration.
+    static char const * sort_src = R"SORT(
+        .ORIG x3000
+        LD   R0, ITERS
+        ST   R0, COUNT
+REPEAT  LD   R1, ARRPTR
+        LD   R2, SIZE
+        LD   R3, STATE
+        LD   R7, INC
+        LD   R0, MASK
+FILL    ADD  R4, R3, R3
+        ADD  R4, R4, R4
+        ADD  R3, R4, R3
+        ADD  R3, R3, R7
+        AND  R4, R3, R0
+        STR  R4, R1, #0
+        ADD  R1, R1, #1
+        ADD  R2, R2, #-1
+        BRp  FILL
+        ST   R3, STATE
+
+        LD   R1, ARRPTR
+        LD   R2, SIZE
+        ADD  R2, R2, #-1
+        ADD  R5, R1, #1
+OUTER   LDR  R3, R5, #0
+        ADD  R4, R5, #-1
+INNER   LDR  R0, R4, #0
+        NOT  R6, R0
+        ADD  R6, R6, #1
+        ADD  R6, R6, R3
+        BRzp PLACE
+        STR  R0, R4, #1
+        ADD  R4, R4, #-1
+        NOT  R6, R1
+        ADD  R6, R6, #1
+        ADD  R6, R6, R4
+        BRzp INNER
+PLACE   STR  R3, R4, #1
+        ADD  R5, R5, #1
+        ADD  R2, R2, #-1
+        BRp  OUTER
+
+        LD   R0, COUNT
+        ADD  R0, R0, #-1
+        ST   R0, COUNT
+        BRnp REPEAT
+        HALT
+ITERS   .FILL #5
+COUNT   .BLKW 1
+STATE   .FILL x1234
+INC     .FILL #13849
+MASK    .FILL x7FFF
+SIZE    .FILL #200
+ARRPTR  .FILL ARRAY
+ARRAY   .BLKW #200
+        .END
+)SORT";
+
+    // Looks up pseudo-random keys in a sorted table, using a table of power-of-two steps instead of halving.
+    static char const * binsearch_src = R"BINSEARCH(
+        .ORIG x3000
+        LD   R1, ARRPTR
+        LD   R2, SIZE
+        AND  R3, R3, #0
+INIT    STR  R3, R1, #0
+        ADD  R3, R3, #3
+        ADD  R1, R1, #1
+        ADD  R2, R2, #-1
+        BRp  INIT
+
+        LD   R5, ITERS
+        LD   R3, STATE
+SEARCH  ADD  R4, R3, R3
+        ADD  R4, R4, R4
+        ADD  R3, R4, R3
+        LD   R4, INC
+        ADD  R3, R3, R4
+        LD   R4, MASK
+        AND  R4, R3, R4
+        LD   R1, ARRM1
+        LEA  R2, STEPS
+STEP    LDR  R0, R2, #0
+        BRz  CHECK
+        ADD  R6, R1, R0
+        LDR  R0, R6, #0
+        NOT  R0, R0
+        ADD  R0, R0, #1
+        ADD  R0, R0, R4
+        BRnz NEXT
+        ADD  R1, R6, #0
+NEXT    ADD  R2, R2, #1
+        BR   STEP
+CHECK   LDR  R0, R1, #1
+        NOT  R0, R0
+        ADD  R0, R0, #1
+        ADD  R0, R0, R4
+        BRnp MISS
+        LD   R0, FOUND
+        ADD  R0, R0, #1
+        ST   R0, FOUND
+MISS    ADD  R5, R5, #-1
+        BRnp SEARCH
+        HALT
+ITERS   .FILL #5000
+STATE   .FILL x4321
+INC     .FILL #13849
+MASK    .FILL x07FF
+FOUND   .FILL #0
+SIZE    .FILL #512
+ARRPTR  .FILL ARRAY
+ARRM1   .FILL ARRAYM1
+STEPS   .FILL #256
+        .FILL #128
+        .FILL #64
+        .FILL #32
+        .FILL #16
+        .FILL #8
+        .FILL #4
+        .FILL #2
+        .FILL #1
+        .FILL #0
+ARRAYM1 .BLKW 1
+ARRAY   .BLKW #512
+        .END
+)BINSEARCH";
+
+    // Naive recursive Fibonacci followed by a single chain of calls thousands of levels deep.
+    static char const * recursion_src = R"RECURSION(
+        .ORIG x3000
+        LD   R6, STACK
+        LD   R5, ITERS
+LOOP    LD   R0, FIBN
+        JSR  FIB
+        ST   R0, FIBRES
+        LD   R0, DEPTH
+        JSR  DEEP
+        ADD  R5, R5, #-1
+        BRnp LOOP
+        HALT
+
+FIB     ADD  R6, R6, #-3
+        STR  R7, R6, #0
+        STR  R1, R6, #1
+        STR  R2, R6, #2
+        ADD  R1, R0, #-2
+        BRn  FIBRET
+        ADD  R0, R0, #-1
+        ADD  R2, R0, #0
+        JSR  FIB
+        ADD  R1, R0, #0
+        ADD  R0, R2, #-1
+        JSR  FIB
+        ADD  R0, R0, R1
+FIBRET  LDR  R7, R6, #0
+        LDR  R1, R6, #1
+        LDR  R2, R6, #2
+        ADD  R6, R6, #3
+        RET
+
+DEEP    ADD  R0, R0, #0
+        BRz  DEEPEND
+        ADD  R6, R6, #-1
+        STR  R7, R6, #0
+        ADD  R0, R0, #-1
+        JSR  DEEP
+        LDR  R7, R6, #0
+        ADD  R6, R6, #1
+DEEPEND RET
+
+ITERS   .FILL #15
+STACK   .FILL xFD00
+FIBN    .FILL #14
+FIBRES  .BLKW 1
+DEPTH   .FILL #2000
+        .END
+)RECURSION";
+
+    // The keyboard interrupt handler queues characters in a ring buffer, and the main loop echoes them with OUT, doing
+    // busy work while the buffer is empty.
+    static char const * interrupt_src = R"INTERRUPT(
+        .ORIG x3000
+        LD   R5, ITERS
+POLL    LD   R1, RIDX
+        LD   R2, WIDX
+        NOT  R3, R2
+        ADD  R3, R3, #1
+        ADD  R3, R3, R1
+        BRz  WORK
+        LD   R2, BUFPTR
+        ADD  R2, R2, R1
+        LDR  R0, R2, #0
+        OUT
+        ADD  R1, R1, #1
+        LD   R2, MASK
+        AND  R1, R1, R2
+        ST   R1, RIDX
+        ADD  R5, R5, #-1
+        BRnp POLL
+        HALT
+WORK    ADD  R4, R4, #1
+        ADD  R4, R4, R4
+        BR   POLL
+
+ISR     ADD  R6, R6, #-3
+        STR  R0, R6, #0
+        STR  R1, R6, #1
+        STR  R2, R6, #2
+        LDI  R0, KBDR
+        LD   R1, WIDX
+        LD   R2, BUFPTR
+        ADD  R2, R2, R1
+        STR  R0, R2, #0
+        ADD  R1, R1, #1
+        LD   R2, MASK
+        AND  R1, R1, R2
+        ST   R1, WIDX
+        LDR  R2, R6, #2
+        LDR  R1, R6, #1
+        LDR  R0, R6, #0
+        ADD  R6, R6, #3
+        RTI
+
+ITERS   .FILL #3000
+RIDX    .FILL #0
+WIDX    .FILL #0
+MASK    .FILL x00FF
+KBDR    .FILL xFE02
+BUFPTR  .FILL BUFFER
+BUFFER  .BLKW #256
+        .END
+
+        .ORIG x0180
+        .FILL ISR
+        .END
+)INTERRUPT";
+
+    // Prints a line with PUTS on every iteration.
+    static char const * puts_src = R"PUTS(
+        .ORIG x3000
+        LD   R5, ITERS
+LOOP    LEA  R0, MSG
+        PUTS
+        ADD  R5, R5, #-1
+        BRnp LOOP
+        HALT
+ITERS   .FILL #600
+MSG     .STRINGZ "The quick brown fox jumps over the lazy dog. 0123456789\n"
+        .END
+)PUTS";
+
+    std::vector<Workload> const & getWorkloads(void)
+    {
+        static std::vector<Workload> const workloads = {
+              { "alu", "arithmetic and logic in tight loops", alu_src, "", 0, false }
+            , { "sort", "insertion sort over an array in memory", sort_src, "", 0, false }
+            , { "binsearch", "binary search over a sorted table", binsearch_src, "", 0, false }
+            , { "recursion", "call-heavy and deep recursion", recursion_src, "", 0, false }
+            , { "interrupt", "interrupt-driven keyboard input echoed to the display", interrupt_src,
+                "the quick brown fox jumps over the lazy dog\n", 100, true }
+            , { "puts", "string output through the PUTS trap", puts_src, "", 0, false }
+        };
+        return workloads;
+    }
+};
+};
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef WORKLOADS_H
+#define WORKLOADS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lc3
+{
+namespace bench
+{
+    // A program in the benchmark corpus.  Every program starts at x3000, reads how many times to repeat its main loop
+    // from the word labeled ITERS, and ends with HALT.  The count is treated as unsigned, so it may be up to 65535.
+    struct Workload
+    {
+        std::string name;
+        std::string description;
+        std::string src;
+        // Keyboard input, supplied one character every input_delay polls and repeated as needed.
+        std::string input;
+        uint32_t input_delay;
+        bool keyboard_interrupts;
+    };
+
+    std::vector<Workload> const & getWorkloads(void);
+};
+};
+
+#endif
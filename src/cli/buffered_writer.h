@@ -0,0 +1,49 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#include <iostream>
+#include <string>
+
+#include "printer.h"
+
+namespace lc3
+{
+    // Collects output in memory and writes it out in large chunks, rather than flushing on every print as
+    // ConsolePrinter does.  Output is only guaranteed to appear once flush is called or the writer is destroyed.
+    class BufferedWriter : public utils::IPrinter
+    {
+    public:
+        static constexpr std::size_t CAPACITY = 1 << 16;
+
+        BufferedWriter(std::ostream & output) : output(output) { buffer.reserve(CAPACITY); }
+        virtual ~BufferedWriter(void) { flush(); }
+
+        virtual void setColor(utils::PrintColor color) override { (void) color; }
+        virtual void print(std::string const & string) override { write(string); }
+        virtual void newline(void) override { write("\n"); }
+
+        void write(std::string const & string)
+        {
+            buffer += string;
+            if(buffer.size() >= CAPACITY) {
+                flush();
+            }
+        }
+
+        void flush(void)
+        {
+            output.write(buffer.data(), buffer.size());
+            output.flush();
+            buffer.clear();
+        }
+
+    private:
+        std::ostream & output;
+        std::string buffer;
+    };
+};
+
+#endif
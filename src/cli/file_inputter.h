@@ -0,0 +1,58 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef FILE_INPUTTER_H
+#define FILE_INPUTTER_H
+
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+
+#include "inputter.h"
+
+namespace lc3
+{
+    // Supplies the contents of a file as keyboard input, one character each time the keyboard is polled.
+    class FileInputter : public utils::IInputter
+    {
+    public:
+        FileInputter(std::string const & filename) : pos(0)
+        {
+            std::ifstream input(filename, std::ios_base::binary);
+            valid = input.is_open();
+            contents.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        }
+        // Reads the whole stream up front, e.g. standard input when it is a pipe.
+        FileInputter(std::istream & input) : pos(0), valid(true)
+        {
+            contents.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        }
+
+        bool isValid(void) const { return valid; }
+
+        virtual void beginInput(void) override {}
+        virtual bool getChar(char & c) override
+        {
+            if(pos >= contents.size()) {
+                return false;
+            }
+            c = contents[pos];
+            pos += 1;
+            return true;
+        }
+        virtual void endInput(void) override {}
+        virtual bool hasRemaining(void) const override { return pos < contents.size(); }
+        virtual uint64_t getIdleCalls(void) const override
+        {
+            return pos >= contents.size() ? std::numeric_limits<uint64_t>::max() : 0;
+        }
+
+    private:
+        std::string contents;
+        std::size_t pos;
+        bool valid;
+    };
+};
+
+#endif
@@ -2,20 +2,23 @@
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
 #include <algorithm>
-#ifdef _ENABLE_DEBUG
-    #include <chrono>
-#endif
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <map>
 #include <vector>
 #include <sstream>
 #include <string>
 
 #define API_VER 2
+#include "buffered_writer.h"
 #include "common.h"
 #include "console_printer.h"
 #include "console_inputter.h"
+#include "file_inputter.h"
 #include "file_printer.h"
 #include "interface.h"
+#include "lc3os.h"
 
 std::string previous_command = "";
 
@@ -30,13 +33,41 @@ struct Breakpoint
 
 std::vector<Breakpoint> breakpoints;
 uint64_t cur_breakpoint_id = 0;
+bool os_symbols_loaded = false;
 
 void help(void);
 bool prompt(lc3::sim & simulator);
 bool promptMain(lc3::sim & simulator, std::stringstream & command_tokens);
 void promptBreak(lc3::sim & simulator, std::stringstream & command_tokens);
+void promptProfile(lc3::sim & simulator, std::stringstream & command_tokens);
+bool loadObjFile(lc3::sim & simulator, std::string const & filename);
+void loadOSSymbols(lc3::sim & simulator);
+std::string formatProfile(lc3::sim & simulator, uint32_t count);
+bool writeFoldedStacks(lc3::sim & simulator, std::string const & filename);
 void list(lc3::sim const & simulator, int32_t context);
 std::string formatMem(lc3::sim const & simulator, uint32_t addr);
+std::string formatRegs(lc3::sim const & simulator);
+std::string formatRegs(lc3::sim const & simulator)
+{
+    std::stringstream out;
+    for(uint32_t i = 0; i < 2; i += 1) {
+        for(uint32_t j = 0; j < 4; j += 1) {
+            uint32_t reg = i * 4 + j;
+            uint32_t value = simulator.readReg(reg);
+            out << lc3::utils::ssprintf("R%u: 0x%0.4X (%5d)", reg, value, value);
+            if(j != 3) {
+                out << "    ";
+            }
+        }
+        out << "\n";
+    }
+    out << lc3::utils::ssprintf("PC: 0x%0.4X\n", simulator.readPC());
+    out << lc3::utils::ssprintf("PSR: 0x%0.4X\n", simulator.readPSR());
+    out << lc3::utils::ssprintf("CC: %c\n", simulator.readCC());
+    out << lc3::utils::ssprintf("MCR: 0x%0.4X\n", simulator.readMCR());
+    return out.str();
+}
+
 std::ostream & operator<<(std::ostream & out, Breakpoint const & x);
 void breakpointCallback(lc3::core::CallbackType type, lc3::sim & sim);
 
@@ -45,8 +76,22 @@ struct CLIArgs
     uint32_t print_level = DEFAULT_PRINT_LEVEL;
     std::string log_file = "";
     bool ignore_privilege = false;
+
+    // Options for running without the interactive prompt.
+    bool headless = false;
+    bool until_halt = false;
+    uint64_t max_insts = 0;
+    std::string input_file = "";
+    bool dump_regs = false;
+    std::vector<std::pair<uint16_t, uint16_t>> dump_mem;
+    uint32_t profile = 0;
+    std::string profile_folded_file = "";
+    bool backtrace = false;
 };
 
+int runHeadless(CLIArgs const & args, int argc, char * argv[]);
+bool parseMemRange(std::string const & range, std::pair<uint16_t, uint16_t> & result);
+
 int main(int argc, char * argv[])
 {
     CLIArgs args;
@@ -58,6 +103,37 @@ int main(int argc, char * argv[])
             args.ignore_privilege = true;
         } else if(std::get<0>(arg) == "log") {
             args.log_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "run") {
+            args.headless = true;
+        } else if(std::get<0>(arg) == "until-halt") {
+            args.headless = true;
+            args.until_halt = true;
+        } else if(std::get<0>(arg) == "max-insts") {
+            args.headless = true;
+            args.max_insts = std::stoull(std::get<1>(arg));
+        } else if(std::get<0>(arg) == "input-file") {
+            args.headless = true;
+            args.input_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "dump-regs") {
+            args.headless = true;
+            args.dump_regs = true;
+        } else if(std::get<0>(arg) == "dump-mem") {
+            std::pair<uint16_t, uint16_t> range;
+            if(! parseMemRange(std::get<1>(arg), range)) {
+                std::cerr << "invalid memory range " << std::get<1>(arg) << "\n";
+                return 1;
+            }
+            args.headless = true;
+            args.dump_mem.push_back(range);
+        } else if(std::get<0>(arg) == "profile") {
+            args.headless = true;
+            args.profile = std::get<1>(arg) != "" ? std::stoi(std::get<1>(arg)) : 10;
+        } else if(std::get<0>(arg) == "profile-folded") {
+            args.headless = true;
+            args.profile_folded_file = std::get<1>(arg);
+        } else if(std::get<0>(arg) == "backtrace") {
+            args.headless = true;
+            args.backtrace = true;
         } else if(std::get<0>(arg) == "h" || std::get<0>(arg) == "help") {
             std::cout << "usage: " << argv[0] << " [OPTIONS] FILE [FILE...]\n";
             std::cout << "\n";
@@ -65,10 +141,24 @@ int main(int argc, char * argv[])
             std::cout << "  --print-level=N        Output verbosity [0-9]\n";
             std::cout << "  --ignore-privilege     Ignore access violations\n";
             std::cout << "  --log=file             Output to log file\n";
+            std::cout << "\n";
+            std::cout << "  --run                  Run without the interactive prompt\n";
+            std::cout << "  --until-halt           Run without the interactive prompt, stopping before HALT\n";
+            std::cout << "  --max-insts=N          Stop after N instructions\n";
+            std::cout << "  --input-file=file      Supply the contents of file as keyboard input (default: piped stdin)\n";
+            std::cout << "  --dump-regs            Print the registers on exit\n";
+            std::cout << "  --dump-mem=a:b         Print memory from address a to b on exit (can be repeated)\n";
+            std::cout << "  --profile[=N]          Print a profile with the N most executed addresses on exit\n";
+            std::cout << "  --profile-folded=file  Write the profiled call chains to file for flame graph tools\n";
+            std::cout << "  --backtrace            Print the routines that have not returned on exit\n";
             return 0;
         }
     }
 
+    if(args.headless) {
+        return runHeadless(args, argc, argv);
+    }
+
     help();
 
     std::shared_ptr<lc3::utils::IPrinter> printer;
@@ -88,7 +178,7 @@ int main(int argc, char * argv[])
     for(int i = 1; i < argc; i += 1) {
         std::string arg(argv[i]);
         if(arg[0] != '-') {
-            simulator.loadObjFile(std::string(argv[i]));
+            loadObjFile(simulator, arg);
         }
     }
 
@@ -99,11 +189,13 @@ int main(int argc, char * argv[])
 
 void help(void)
 {
-    std::cout << "break <action> [args...] - performs action (see break help for details)\n"
+    std::cout << "backtrace                - display the routines that have been entered but not returned from\n"
+              << "break <action> [args...] - performs action (see break help for details)\n"
               << "help                     - display this message\n"
               << "list [N]                 - display the next instruction to be executed with N rows of context\n"
               << "load <filename>          - loads an object file\n"
               << "mem <start> [<end>]      - display values in memory addresses start to end\n"
+              << "profile <action> [args]  - counts executed instructions (see profile help for details)\n"
 #ifdef _ENABLE_DEBUG
               << "printlevel N             - sets the print level to N\n"
 #endif
@@ -129,6 +221,18 @@ void breakHelp(void)
               ;
 }
 
+void profileHelp(void)
+{
+    std::cout << "profile clear          - resets the counts\n"
+              << "profile folded <file>  - writes the call chains to file in the format read by flame graph tools\n"
+              << "profile help           - display this message\n"
+              << "profile off            - stops counting executed instructions\n"
+              << "profile on             - starts counting executed instructions\n"
+              << "profile show [N]       - display the counts, with the N most executed addresses, branches,\n"
+              << "                         routines, and calls\n"
+              ;
+}
+
 bool prompt(lc3::sim & simulator)
 {
     std::cout << "Executed " << simulator.getInstExecCount() << " instructions\n";
@@ -152,7 +256,10 @@ bool promptMain(lc3::sim & simulator, std::stringstream & command_tokens)
     std::string command;
     command_tokens >> command;
 
-    if(command == "break") {
+    if(command == "backtrace") {
+        loadOSSymbols(simulator);
+        std::cout << simulator.getBacktrace();
+    } else if(command == "break") {
         promptBreak(simulator, command_tokens);
     } else if(command == "help") {
         help();
@@ -171,7 +278,7 @@ bool promptMain(lc3::sim & simulator, std::stringstream & command_tokens)
             return true;
         }
 
-        simulator.loadObjFile(filename);
+        loadObjFile(simulator, filename);
     } else if(command == "mem") {
         std::string start_s, end_s;
         command_tokens >> start_s;
@@ -209,6 +316,8 @@ bool promptMain(lc3::sim & simulator, std::stringstream & command_tokens)
         }
         simulator.setPrintLevel(print_level);
 #endif
+    } else if(command == "profile") {
+        promptProfile(simulator, command_tokens);
     } else if(command == "quit") {
         return false;
     } else if(command == "randomize") {
@@ -216,21 +325,7 @@ bool promptMain(lc3::sim & simulator, std::stringstream & command_tokens)
     } else if(command == "restart") {
         simulator.setup();
     } else if(command == "regs") {
-        for(uint32_t i = 0; i < 2; i += 1) {
-            for(uint32_t j = 0; j < 4; j += 1) {
-                uint32_t reg = i * 4 + j;
-                uint32_t value = simulator.readReg(reg);
-                std::cout << lc3::utils::ssprintf("R%u: 0x%0.4X (%5d)", reg, value, value);
-                if(j != 3) {
-                    std::cout << "    ";
-                }
-            }
-            std::cout << "\n";
-        }
-        std::cout << lc3::utils::ssprintf("PC: 0x%0.4X\n", simulator.readPC());
-        std::cout << lc3::utils::ssprintf("PSR: 0x%0.4X\n", simulator.readPSR());
-        std::cout << lc3::utils::ssprintf("CC: %c\n", simulator.readCC());
-        std::cout << lc3::utils::ssprintf("MCR: 0x%0.4X\n", simulator.readMCR());
+        std::cout << formatRegs(simulator);
     } else if(command == "run") {
         uint32_t inst_limit;
         command_tokens >> inst_limit;
@@ -371,6 +466,227 @@ void promptBreak(lc3::sim & simulator, std::stringstream & command_tokens)
     }
 }
 
+void promptProfile(lc3::sim & simulator, std::stringstream & command_tokens)
+{
+    std::string command;
+    command_tokens >> command;
+    if(command_tokens.fail()) {
+        std::cout << "must provide action\n";
+        return;
+    }
+
+    if(command == "clear") {
+        simulator.clearProfile();
+    } else if(command == "folded") {
+        std::string filename;
+        command_tokens >> filename;
+        if(command_tokens.fail()) {
+            std::cout << "must supply filename\n";
+            return;
+        }
+        writeFoldedStacks(simulator, filename);
+    } else if(command == "help") {
+        profileHelp();
+    } else if(command == "off") {
+        simulator.setProfiling(false);
+    } else if(command == "on") {
+        simulator.setProfiling(true);
+    } else if(command == "show") {
+        uint32_t count;
+        command_tokens >> count;
+        if(command_tokens.fail()) {
+            count = 10;
+        }
+        std::cout << formatProfile(simulator, count);
+    } else {
+        std::cout << "unknown command\n";
+    }
+}
+
+// Object files do not include symbols, so they are taken from the source file next to the object file, if there is
+// one.
+bool loadObjFile(lc3::sim & simulator, std::string const & filename)
+{
+    if(! simulator.loadObjFile(filename)) {
+        return false;
+    }
+
+    std::ifstream asm_file(filename.substr(0, filename.find_last_of('.')) + ".asm");
+    if(asm_file) {
+        lc3::utils::NullPrinter printer;
+        lc3::core::Assembler assembler(printer, 0, true);
+        try {
+            simulator.addSymbols(assembler.assemble(asm_file).second);
+        } catch(lc3::utils::exception const & e) {
+            (void) e;
+        }
+    }
+    return true;
+}
+
+std::string formatProfile(lc3::sim & simulator, uint32_t count)
+{
+    static char const * const opcode_names[] = { "BR", "ADD", "LD", "ST", "JSR", "AND", "LDR", "STR", "RTI", "NOT",
+        "LDI", "STI", "JMP", "RES", "LEA", "TRAP" };
+
+    lc3::core::Profile const * profile = simulator.getProfile();
+    if(profile == nullptr) {
+        return "profiling is not enabled\n";
+    }
+    loadOSSymbols(simulator);
+
+    std::stringstream out;
+    uint64_t total = profile->getInstCount();
+    out << lc3::utils::ssprintf("Profiled %llu instructions\n", static_cast<unsigned long long>(total));
+    if(total == 0) {
+        return out.str();
+    }
+
+    out << "Opcodes:\n";
+    for(uint32_t opcode = 0; opcode < 16; opcode += 1) {
+        if(profile->opcodes[opcode] != 0) {
+            out << lc3::utils::ssprintf("  %-5s %12llu %6.2f%%\n", opcode_names[opcode],
+                static_cast<unsigned long long>(profile->opcodes[opcode]), 100.0 * profile->opcodes[opcode] / total);
+        }
+    }
+
+    // Addresses are ordered by count, and then by address.
+    auto top = [count](std::vector<std::pair<uint64_t, uint16_t>> & entries) {
+        std::size_t size = std::min<std::size_t>(count, entries.size());
+        std::partial_sort(entries.begin(), entries.begin() + size, entries.end(),
+            [](std::pair<uint64_t, uint16_t> const & lhs, std::pair<uint64_t, uint16_t> const & rhs) {
+                return lhs.first > rhs.first || (lhs.first == rhs.first && lhs.second < rhs.second);
+            });
+        entries.resize(size);
+    };
+
+    std::vector<std::pair<uint64_t, uint16_t>> hot_spots, branches;
+    for(uint32_t addr = 0; addr < profile->pcs.size(); addr += 1) {
+        if(profile->pcs[addr] != 0) {
+            hot_spots.emplace_back(profile->pcs[addr], static_cast<uint16_t>(addr));
+        }
+        uint64_t branch_count = profile->branches_taken[addr] + profile->branches_not_taken[addr];
+        if(branch_count != 0) {
+            branches.emplace_back(branch_count, static_cast<uint16_t>(addr));
+        }
+    }
+    top(hot_spots);
+    top(branches);
+
+    out << "Hot spots:\n";
+    for(std::pair<uint64_t, uint16_t> const & entry : hot_spots) {
+        out << lc3::utils::ssprintf("  0x%0.4X %-20s %12llu %6.2f%%  %s\n", entry.second,
+            simulator.symbolize(entry.second).c_str(), static_cast<unsigned long long>(entry.first),
+            100.0 * entry.first / total, simulator.getMemLine(entry.second).c_str());
+    }
+
+    if(! branches.empty()) {
+        out << "Branches:\n";
+    }
+    for(std::pair<uint64_t, uint16_t> const & entry : branches) {
+        uint64_t taken = profile->branches_taken[entry.second];
+        out << lc3::utils::ssprintf("  0x%0.4X %-20s %12llu taken %12llu not taken %6.2f%% taken\n", entry.second,
+            simulator.symbolize(entry.second).c_str(), static_cast<unsigned long long>(taken),
+            static_cast<unsigned long long>(entry.first - taken), 100.0 * taken / entry.first);
+    }
+
+    bool any_traps = false;
+    for(uint32_t vec = 0; vec < profile->traps.size(); vec += 1) {
+        if(profile->traps[vec] != 0) {
+            if(! any_traps) {
+                out << "Traps:\n";
+                any_traps = true;
+            }
+            // The trap table is at the start of memory, so the vector is also the address of the routine's entry.
+            out << lc3::utils::ssprintf("  x%0.2X    %-20s %12llu\n", vec,
+                simulator.symbolize(simulator.readMem(static_cast<uint16_t>(vec))).c_str(),
+                static_cast<unsigned long long>(profile->traps[vec]));
+        }
+    }
+
+    // Routines and calls are ordered by inclusive count.
+    std::vector<lc3::core::RoutineStats> routine_stats = profile->getRoutineStats();
+    std::sort(routine_stats.begin(), routine_stats.end(),
+        [](lc3::core::RoutineStats const & lhs, lc3::core::RoutineStats const & rhs) {
+            return lhs.inclusive > rhs.inclusive || (lhs.inclusive == rhs.inclusive && lhs.routine < rhs.routine);
+        });
+    routine_stats.resize(std::min<std::size_t>(count, routine_stats.size()));
+    if(! routine_stats.empty()) {
+        out << lc3::utils::ssprintf("Routines:%31s %12s %12s %9s\n", "calls", "inclusive", "exclusive", "max depth");
+    }
+    for(lc3::core::RoutineStats const & routine : routine_stats) {
+        out << lc3::utils::ssprintf("  0x%0.4X %-20s %10llu %12llu %12llu %9u\n", routine.routine,
+            simulator.getRoutineName(routine.routine).c_str(), static_cast<unsigned long long>(routine.calls),
+            static_cast<unsigned long long>(routine.inclusive), static_cast<unsigned long long>(routine.exclusive),
+            routine.max_depth);
+    }
+
+    std::vector<lc3::core::CallEdgeStats> edge_stats = profile->getCallEdgeStats();
+    std::sort(edge_stats.begin(), edge_stats.end(),
+        [](lc3::core::CallEdgeStats const & lhs, lc3::core::CallEdgeStats const & rhs) {
+            return lhs.inclusive > rhs.inclusive || (lhs.inclusive == rhs.inclusive &&
+                std::make_pair(lhs.caller, lhs.callee) < std::make_pair(rhs.caller, rhs.callee));
+        });
+    edge_stats.resize(std::min<std::size_t>(count, edge_stats.size()));
+    if(! edge_stats.empty()) {
+        out << lc3::utils::ssprintf("Calls:%49s %12s\n", "calls", "inclusive");
+    }
+    for(lc3::core::CallEdgeStats const & edge : edge_stats) {
+        std::string names = simulator.getRoutineName(edge.caller) + " -> " + simulator.getRoutineName(edge.callee);
+        out << lc3::utils::ssprintf("  %-42s %10llu %12llu\n", names.c_str(),
+            static_cast<unsigned long long>(edge.calls), static_cast<unsigned long long>(edge.inclusive));
+    }
+
+    std::pair<char const *, std::map<uint16_t, uint64_t> const *> routines[] = {
+        { "Interrupts", &profile->interrupts }, { "Exceptions", &profile->exceptions } };
+    for(auto const & routine : routines) {
+        if(! routine.second->empty()) {
+            out << routine.first << ":\n";
+        }
+        for(auto const & entry : *routine.second) {
+            out << lc3::utils::ssprintf("  0x%0.4X %-20s %12llu\n", entry.first,
+                simulator.symbolize(entry.first).c_str(), static_cast<unsigned long long>(entry.second));
+        }
+    }
+
+    return out.str();
+}
+
+bool writeFoldedStacks(lc3::sim & simulator, std::string const & filename)
+{
+    if(simulator.getProfile() == nullptr) {
+        std::cerr << "profiling is not enabled\n";
+        return false;
+    }
+    loadOSSymbols(simulator);
+
+    std::ofstream out(filename);
+    if(! out) {
+        std::cerr << "could not open file " << filename << "\n";
+        return false;
+    }
+    out << simulator.getFoldedStacks();
+    return true;
+}
+
+// The OS is built in, so its symbols come from assembling its source.  This is only done once a profile is shown.
+void loadOSSymbols(lc3::sim & simulator)
+{
+    if(os_symbols_loaded) {
+        return;
+    }
+
+    lc3::utils::NullPrinter printer;
+    lc3::core::Assembler assembler(printer, 0, false);
+    std::stringstream os_src(lc3::core::getOSSrc());
+    try {
+        simulator.addSymbols(assembler.assemble(os_src).second);
+    } catch(lc3::utils::exception const & e) {
+        (void) e;
+    }
+    os_symbols_loaded = true;
+}
+
 void list(lc3::sim const & simulator, int32_t context)
 {
     uint32_t pc = simulator.readPC();
@@ -414,3 +730,125 @@ void breakpointCallback(lc3::core::CallbackType type, lc3::sim & sim)
         std::cout << "hit a breakpoint\n" << *bp_search << "\n";
     }
 }
+
+int runHeadless(CLIArgs const & args, int argc, char * argv[])
+{
+    std::ofstream log_output;
+    if(args.log_file != "") {
+        log_output.open(args.log_file);
+        if(! log_output) {
+            std::cerr << "could not open file " << args.log_file << "\n";
+            return 1;
+        }
+    }
+    lc3::BufferedWriter writer(args.log_file != "" ? static_cast<std::ostream &>(log_output) : std::cout);
+
+    std::shared_ptr<lc3::utils::IInputter> inputter;
+    if(args.input_file != "") {
+        std::shared_ptr<lc3::FileInputter> file_inputter = std::make_shared<lc3::FileInputter>(args.input_file);
+        if(! file_inputter->isValid()) {
+            std::cerr << "could not open file " << args.input_file << "\n";
+            return 1;
+        }
+        inputter = file_inputter;
+    } else if(! isStdinTerminal()) {
+        inputter = std::make_shared<lc3::FileInputter>(std::cin);
+    } else {
+        inputter = std::make_shared<lc3::utils::NullInputter>();
+    }
+
+    lc3::sim simulator(writer, *inputter, args.print_level);
+    if(args.ignore_privilege) {
+        simulator.setIgnorePrivilege(true);
+    }
+
+    // Without an instruction limit, a program that waits for input after all of it has been consumed would poll the
+    // keyboard forever, so the run is stopped the first time it does.
+    bool input_exhausted = false;
+    if(args.max_insts == 0) {
+        simulator.registerCallback(lc3::core::CallbackType::INPUT_POLL,
+            [&inputter, &input_exhausted](lc3::core::CallbackType type, lc3::sim & sim) {
+                (void) type;
+                if((sim.readMem(KBSR) & 0x8000) == 0 && ! inputter->hasRemaining()) {
+                    input_exhausted = true;
+                    sim.asyncInterrupt();
+                }
+            });
+    }
+
+    for(int i = 1; i < argc; i += 1) {
+        std::string arg(argv[i]);
+        if(arg[0] != '-' && ! loadObjFile(simulator, arg)) {
+            writer.flush();
+            return 1;
+        }
+    }
+    if(args.profile != 0 || args.profile_folded_file != "") {
+        simulator.setProfiling(true);
+    }
+
+    simulator.setRunInstLimit(args.max_insts);
+    uint64_t start_count = simulator.getInstExecCount();
+    auto start = std::chrono::steady_clock::now();
+    bool success = args.until_halt ? simulator.runUntilHalt() : simulator.run();
+    auto end = std::chrono::steady_clock::now();
+    uint64_t inst_count = simulator.getInstExecCount() - start_count;
+    if(input_exhausted) {
+        success = false;
+    }
+
+    if(args.dump_regs) {
+        writer.write(formatRegs(simulator));
+    }
+    for(std::pair<uint16_t, uint16_t> const & range : args.dump_mem) {
+        for(uint32_t addr = range.first; addr <= range.second; addr += 1) {
+            writer.write(formatMem(simulator, addr) + "\n");
+        }
+    }
+    writer.flush();
+
+    // The statistics go to stderr so that they do not mix with the program output.
+    double elapsed = std::chrono::duration<double>(end - start).count();
+    double mips = elapsed > 0 ? inst_count / elapsed / 1e6 : 0;
+    std::cerr << lc3::utils::ssprintf("stats: %llu instructions, %.3f s, %.2f MIPS, %.1f MiB peak RSS\n",
+        static_cast<unsigned long long>(inst_count), elapsed, mips, getPeakRSS() / (1024.0 * 1024.0));
+    if(input_exhausted) {
+        std::cerr << lc3::utils::ssprintf("stopped at x%04X: the program is waiting for input, but none is left\n",
+            simulator.readPC());
+    }
+    if(args.profile != 0) {
+        std::cerr << formatProfile(simulator, args.profile);
+    }
+    if(args.backtrace) {
+        loadOSSymbols(simulator);
+        std::cerr << "Backtrace:\n" << simulator.getBacktrace();
+    }
+    if(args.profile_folded_file != "" && ! writeFoldedStacks(simulator, args.profile_folded_file)) {
+        return 1;
+    }
+
+    return success ? 0 : 1;
+}
+
+bool parseMemRange(std::string const & range, std::pair<uint16_t, uint16_t> & result)
+{
+    std::size_t colon = range.find(':');
+    std::string start_s = range.substr(0, colon);
+    std::string end_s = colon == std::string::npos ? start_s : range.substr(colon + 1);
+
+    uint32_t start, end;
+    try {
+        start = std::stoi(start_s, 0, 0);
+        end = std::stoi(end_s, 0, 0);
+    } catch(std::exception const & e) {
+        (void) e;
+        return false;
+    }
+
+    if(start > end || end > 0xffff) {
+        return false;
+    }
+
+    result = std::make_pair(static_cast<uint16_t>(start), static_cast<uint16_t>(end));
+    return true;
+}
@@ -1,8 +1,21 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include <algorithm>
+#include <cstdio>
 #include <cstring>
 
+#ifdef _WIN32
+    #include <windows.h>
+    #include <io.h>
+    #include <psapi.h>
+#else
+    #include <dirent.h>
+    #include <sys/resource.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 #include "common.h"
 
 std::vector<std::pair<std::string, std::string>> parseCLIArgs(int argc, char * argv[])
@@ -30,3 +43,77 @@ std::vector<std::pair<std::string, std::string>> parseCLIArgs(int argc, char * a
     return parsed_args;
 }
 
+
+std::vector<std::string> listDirectory(std::string const & path, bool directories_only)
+{
+    std::vector<std::string> names;
+
+#ifdef _WIN32
+    WIN32_FIND_DATAA entry;
+    HANDLE handle = FindFirstFileA((path + "\\*").c_str(), &entry);
+    if(handle == INVALID_HANDLE_VALUE) {
+        return names;
+    }
+    do {
+        std::string name(entry.cFileName);
+        bool is_directory = (entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        if(name != "." && name != ".." && (! directories_only || is_directory)) {
+            names.push_back(name);
+        }
+    } while(FindNextFileA(handle, &entry));
+    FindClose(handle);
+#else
+    DIR * dir = opendir(path.c_str());
+    if(dir == nullptr) {
+        return names;
+    }
+    for(struct dirent * entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+        std::string name(entry->d_name);
+        if(name == "." || name == "..") {
+            continue;
+        }
+        if(directories_only) {
+            struct stat info;
+            if(stat((path + "/" + name).c_str(), &info) != 0 || ! S_ISDIR(info.st_mode)) {
+                continue;
+            }
+        }
+        names.push_back(name);
+    }
+    closedir(dir);
+#endif
+
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+uint64_t getPeakRSS(void)
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if(! GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    #ifdef __APPLE__
+        return usage.ru_maxrss;
+    #else
+        // Linux reports kilobytes.
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+    #endif
+#endif
+}
+
+bool isStdinTerminal(void)
+{
+#ifdef _WIN32
+    return _isatty(_fileno(stdin)) != 0;
+#else
+    return isatty(fileno(stdin)) != 0;
+#endif
+}
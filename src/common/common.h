@@ -4,9 +4,17 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 std::vector<std::pair<std::string, std::string>> parseCLIArgs(int argc, char * argv[]);
+// Sorted names of the entries in a directory, excluding "." and "..", and optionally only those that are directories.
+// Empty if the directory cannot be read.
+std::vector<std::string> listDirectory(std::string const & path, bool directories_only);
+// Largest resident set size the process has reached so far, in bytes, or 0 if it is not available.
+uint64_t getPeakRSS(void);
+// Whether standard input is an interactive terminal, as opposed to a file or pipe.
+bool isStdinTerminal(void);
 
 #endif
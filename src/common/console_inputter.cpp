@@ -28,6 +28,8 @@ void lc3::ConsoleInputter::beginInput(void)
 
 bool lc3::ConsoleInputter::getChar(char & c)
 {
+    skipped_polls = 0;
+
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32)
     if(_kbhit() != 0) {
         c = _getch();
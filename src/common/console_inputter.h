@@ -10,15 +10,25 @@ namespace lc3 {
     class ConsoleInputter : public utils::IInputter
     {
     public:
-        ConsoleInputter(void) = default;
+        ConsoleInputter(void) : skipped_polls(0) {}
         ~ConsoleInputter(void) = default;
 
         virtual void beginInput(void) override;
         virtual bool getChar(char & c) override;
         virtual void endInput(void) override;
         virtual bool hasRemaining(void) const override { return false; }
+        // Keys arrive whenever they are typed, so a key noticed a few hundred instructions after it was typed is no
+        // different from one typed a moment later.  Polling is a system call, so most polls may be skipped.
+        virtual uint64_t getIdleCalls(void) const override
+        {
+            return skipped_polls < MAX_SKIPPED_POLLS ? MAX_SKIPPED_POLLS - skipped_polls : 0;
+        }
+        virtual void skipIdleCalls(uint64_t count) override { skipped_polls += count; }
 
     private:
+        static constexpr uint64_t MAX_SKIPPED_POLLS = 256;
+        uint64_t skipped_polls;
+
 #if !(defined(WIN32) || defined(_WIN32) || defined(__WIN32))
         int kbhit(void);
 #endif
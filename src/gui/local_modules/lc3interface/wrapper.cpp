@@ -609,6 +609,16 @@ NAN_METHOD(GetInstExecCount)
     }
 }
 
+NAN_METHOD(GetBacktrace)
+{
+    try {
+        auto ret = Nan::New<v8::String>(sim->getBacktrace()).ToLocalChecked();
+        info.GetReturnValue().Set(ret);
+    } catch(std::exception const & e) {
+        Nan::ThrowError(e.what());
+    }
+}
+
 NAN_METHOD(DidHitBreakpoint)
 {
     try {
@@ -655,6 +665,7 @@ NAN_MODULE_INIT(NanInit)
     NAN_EXPORT(target, RemoveBreakpoint);
 
     NAN_EXPORT(target, GetInstExecCount);
+    NAN_EXPORT(target, GetBacktrace);
     NAN_EXPORT(target, DidHitBreakpoint);
 }
 
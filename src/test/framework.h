@@ -26,7 +26,7 @@
         framework2::testBringup = testBringup;
         framework2::testTeardown = testTeardown;
 
-        framework2::main(argc, argv);
+        return framework2::main(argc, argv);
     }
 #else
     #include "framework1.h"
@@ -54,6 +54,6 @@
         framework1::testBringup = testBringup;
         framework1::testTeardown = testTeardown;
 
-        framework1::main(argc, argv);
+        return framework1::main(argc, argv);
     }
 #endif
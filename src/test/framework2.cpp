@@ -1,12 +1,18 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include <algorithm>
+#include <fstream>
 #include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
 #include <math.h>
 
 #include "common.h"
 #include "console_printer.h"
 #include "framework2.h"
+#include "thread_pool.h"
 
 namespace framework2
 {
@@ -20,6 +26,11 @@ struct CLIArgs
     bool ignore_privilege = false;
     bool tester_verbose = false;
     uint64_t seed = 0;
+    uint32_t jobs = 1;
+    bool jobs_override = false;
+    uint32_t seeds = 1;
+    lc3::core::EngineType engine = lc3::core::EngineType::AUTO;
+    std::string batch_root;
     std::vector<std::string> test_filter;
 };
 
@@ -30,6 +41,54 @@ std::function<void(void)> shutdown = nullptr;
 std::function<void(lc3::sim &)> testBringup = nullptr;
 std::function<void(lc3::sim &)> testTeardown = nullptr;
 
+// Assembles (or converts) each file that is not already an object file.  Returns false if any of them failed, in which
+// case obj_filenames only holds the ones that succeeded.
+static bool assembleFiles(std::vector<std::string> const & filenames, lc3::utils::IPrinter & printer,
+    uint32_t asm_print_level, std::vector<std::string> & obj_filenames, lc3::core::SymbolTable & symbol_table)
+{
+    lc3::as assembler(printer, asm_print_level, false);
+    lc3::conv converter(printer, asm_print_level);
+
+    bool valid_program = true;
+    for(std::string const & filename : filenames) {
+        lc3::optional<std::string> result;
+        if(! endsWith(filename, ".obj")) {
+            if(endsWith(filename, ".bin")) {
+                result = converter.convertBin(filename);
+            } else {
+                lc3::optional<std::pair<std::string, lc3::core::SymbolTable>> asm_result;
+                asm_result = assembler.assemble(filename);
+                if(asm_result) {
+                    symbol_table.insert(asm_result->second.begin(), asm_result->second.end());
+                    result = asm_result->first;
+                }
+            }
+        } else {
+            result = filename;
+        }
+
+        if(result) {
+            obj_filenames.push_back(*result);
+        } else {
+            valid_program = false;
+        }
+    }
+
+    return valid_program;
+}
+
+static std::string escapeJSON(std::string const & str)
+{
+    std::string ret;
+    for(char c : str) {
+        if(c == '"' || c == '\\') {
+            ret += '\\';
+        }
+        ret += c;
+    }
+    return ret;
+}
+
 int main(int argc, char * argv[])
 {
     if(setup == nullptr || shutdown == nullptr || testBringup == nullptr || testTeardown == nullptr) {
@@ -57,10 +116,39 @@ int main(int argc, char * argv[])
             args.tester_verbose = true;
         } else if(std::get<0>(arg) == "seed") {
             args.seed = std::stoull(std::get<1>(arg));
+        } else if(std::get<0>(arg) == "jobs") {
+            int jobs = std::stoi(std::get<1>(arg));
+            if(jobs < 0) {
+                std::cerr << "invalid number of jobs " << std::get<1>(arg) << "\n";
+                return 1;
+            }
+            args.jobs = static_cast<uint32_t>(jobs);
+            args.jobs_override = true;
+            if(args.jobs == 0) {
+                args.jobs = std::max(std::thread::hardware_concurrency(), 1u);
+            }
+        } else if(std::get<0>(arg) == "seeds") {
+            args.seeds = std::max(std::stoi(std::get<1>(arg)), 1);
+        } else if(std::get<0>(arg) == "engine") {
+            if(std::get<1>(arg) == "auto") {
+                args.engine = lc3::core::EngineType::AUTO;
+            } else if(std::get<1>(arg) == "detailed") {
+                args.engine = lc3::core::EngineType::DETAILED;
+            } else if(std::get<1>(arg) == "fast") {
+                args.engine = lc3::core::EngineType::FAST;
+            } else if(std::get<1>(arg) == "jit") {
+                args.engine = lc3::core::EngineType::JIT;
+            } else {
+                std::cerr << "invalid engine " << std::get<1>(arg) << "\n";
+                return 1;
+            }
+        } else if(std::get<0>(arg) == "batch") {
+            args.batch_root = std::get<1>(arg);
         } else if(std::get<0>(arg) == "test-filter") {
             args.test_filter.push_back(std::get<1>(arg));
         } else if(std::get<0>(arg) == "h" || std::get<0>(arg) == "help") {
             std::cout << "usage: " << argv[0] << " [OPTIONS] FILE [FILE...]\n";
+            std::cout << "       " << argv[0] << " [OPTIONS] --batch=DIR [FILE...]\n";
             std::cout << "\n";
             std::cout << "  -h,--help              Print this message\n";
             std::cout << "  --print-output         Print program output\n";
@@ -69,45 +157,40 @@ int main(int argc, char * argv[])
             std::cout << "  --ignore-privilege     Ignore access violations\n";
             std::cout << "  --tester-verbose       Output tester messages\n";
             std::cout << "  --seed=N               Optional seed for randomization\n";
+            std::cout << "  --seeds=K              Run randomized tests under K seeds, starting from --seed\n";
+            std::cout << "  --jobs=N               Run up to N tests in parallel (0 for one per core)\n";
             std::cout << "  --test-filter=TEST     Only run TEST (can be repeated)\n";
+            std::cout << "  --engine=ENGINE        Simulate with ENGINE: auto, detailed, fast, or jit (default auto)\n";
+            std::cout << "  --batch=DIR            Grade every submission directory in DIR (FILEs are relative to each)\n";
             return 0;
         }
     }
 
-    lc3::ConsolePrinter asm_printer;
-    lc3::as assembler(asm_printer, args.asm_print_level_override ? args.asm_print_level : 0, false);
-    lc3::conv converter(asm_printer, args.asm_print_level_override ? args.asm_print_level : 0);
-    lc3::core::SymbolTable symbol_table;
-
-    std::vector<std::string> obj_filenames;
-    bool valid_program = true;
+    uint32_t asm_print_level = args.asm_print_level_override ? args.asm_print_level : 0;
+    std::vector<std::string> filenames;
     for(int i = 1; i < argc; i += 1) {
-        std::string filename(argv[i]);
-        if(filename[0] != '-') {
-            lc3::optional<std::string> result;
-            if(! endsWith(filename, ".obj")) {
-                if(endsWith(filename, ".bin")) {
-                    result = converter.convertBin(filename);
-                } else {
-                    lc3::optional<std::pair<std::string, lc3::core::SymbolTable>> asm_result;
-                    asm_result = assembler.assemble(filename);
-                    if(asm_result) {
-                        symbol_table.insert(asm_result->second.begin(), asm_result->second.end());
-                        result = asm_result->first;
-                    }
-                }
-            } else {
-                result = filename;
-            }
-
-            if(result) {
-                obj_filenames.push_back(*result);
-            } else {
-                valid_program = false;
-            }
+        if(argv[i][0] != '-') {
+            filenames.push_back(argv[i]);
         }
     }
 
+    if(! args.batch_root.empty()) {
+        Tester tester(args.print_output, args.sim_print_level_override ? args.sim_print_level : 1,
+            args.ignore_privilege, args.tester_verbose, args.seed, {});
+        tester.setConcurrency(args.jobs_override ? args.jobs : std::max(std::thread::hardware_concurrency(), 1u),
+            args.seeds);
+        tester.setEngineType(args.engine);
+        setup(tester);
+        tester.testBatch(args.batch_root, filenames, asm_print_level);
+        shutdown();
+        return 0;
+    }
+
+    lc3::ConsolePrinter asm_printer;
+    lc3::core::SymbolTable symbol_table;
+    std::vector<std::string> obj_filenames;
+    bool valid_program = assembleFiles(filenames, asm_printer, asm_print_level, obj_filenames, symbol_table);
+
     if(obj_filenames.size() == 0) {
         return 1;
     }
@@ -116,6 +199,8 @@ int main(int argc, char * argv[])
         Tester tester(args.print_output, args.sim_print_level_override ? args.sim_print_level : 1,
             args.ignore_privilege, args.tester_verbose, args.seed, obj_filenames);
         tester.setSymbolTable(symbol_table);
+        tester.setConcurrency(args.jobs, args.seeds);
+        tester.setEngineType(args.engine);
         setup(tester);
 
         if(args.test_filter.size() == 0) {
@@ -139,7 +224,10 @@ TestCase::TestCase(std::string const & name, test_func_t test_func, double point
 Tester::Tester(bool print_output, uint32_t print_level, bool ignore_privilege, bool verbose,
     uint64_t seed, std::vector<std::string> const & obj_filenames)
     : print_output(print_output), ignore_privilege(ignore_privilege), verbose(verbose),
-      print_level(print_level), seed(seed), obj_filenames(obj_filenames)
+      print_level(print_level), seed(seed), num_jobs(1), num_seeds(1), engine_type(lc3::core::EngineType::AUTO),
+      obj_filenames(obj_filenames),
+      out(&std::cout), printer(nullptr), inputter(nullptr), simulator(nullptr),
+      templates(std::make_shared<TemplateCache>())
 {
     resetTestPoints();
 }
@@ -149,68 +237,240 @@ void Tester::registerTest(std::string const & name, test_func_t test_func, doubl
     tests.emplace_back(name, test_func, points, randomize);
 }
 
-std::pair<double, double> Tester::testAll(void)
+void Tester::setConcurrency(uint32_t num_jobs, uint32_t num_seeds)
 {
-    std::cout << "{\n";
+    this->num_jobs = std::max(num_jobs, 1u);
+    this->num_seeds = std::max(num_seeds, 1u);
+}
 
-    std::cout << "    \"tests\": [\n";
-    double total_points_earned = 0, total_points = 0;
+std::vector<Tester::TestRun> Tester::getTestRuns(void)
+{
+    // Runs may happen in any order, so the seed is picked up front instead of by the first randomized test.
+    bool any_randomized = std::any_of(tests.begin(), tests.end(), [](TestCase const & test) { return test.randomize; });
+    if(any_randomized && seed == 0) {
+        std::random_device dev;
+        seed = dev();
+    }
+
+    std::vector<TestRun> runs;
     for(TestCase const & test : tests) {
-        auto points = testSingle(test);
-        total_points_earned += std::get<0>(points);
-        total_points += std::get<1>(points);
+        if(test.randomize) {
+            for(uint32_t i = 0; i < num_seeds; i += 1) {
+                runs.push_back({&test, seed + i, test.points / num_seeds});
+            }
+        } else {
+            runs.push_back({&test, seed, test.points});
+        }
     }
-    std::cout << "    ]\n";
+    return runs;
+}
 
-    std::cout << "    \"leaderboard\": [],\n";
-    std::cout << "    \"visibility\": \"visible\",\n";
-    std::cout << "    \"execution_time\": 0,\n";
-    std::cout << "    \"score\": " << total_points_earned << "\n";
+std::pair<double, double> Tester::testAll(void)
+{
+    std::vector<TestRun> runs = getTestRuns();
+    std::vector<std::pair<double, double>> points(runs.size());
 
-    std::cout << "}\n";
+    printReportHeader(std::cout);
+    if(num_jobs == 1) {
+        for(std::size_t i = 0; i < runs.size(); i += 1) {
+            points[i] = testRun(runs[i], std::cout);
+        }
+    } else {
+        std::vector<std::string> run_outputs(runs.size());
+        std::vector<ThreadPool::Task> tasks;
+        for(std::size_t i = 0; i < runs.size(); i += 1) {
+            tasks.push_back([this, i, &runs, &points, &run_outputs]() {
+                std::ostringstream run_out;
+                points[i] = testRun(runs[i], run_out);
+                run_outputs[i] = run_out.str();
+            });
+        }
 
+        ThreadPool pool(num_jobs);
+        pool.run(tasks);
+
+        for(std::string const & run_output : run_outputs) {
+            std::cout << run_output;
+        }
+    }
+
+    std::pair<double, double> total_points = sumPoints(points);
+    printReportFooter(std::cout, std::get<0>(total_points));
+
+    return total_points;
+}
+
+void Tester::testBatch(std::string const & root, std::vector<std::string> const & filenames, uint32_t asm_print_level)
+{
+    struct Submission
+    {
+        Submission(Tester const & prototype, std::string const & name, std::string const & path) :
+            name(name), path(path), tester(prototype), valid(false)
+        {}
+
+        std::string name, path;
+        Tester tester;
+        BufferedPrinter asm_printer{false};
+        bool valid;
+        std::vector<std::string> run_outputs;
+        std::vector<std::pair<double, double>> points;
+    };
+
+    std::vector<TestRun> runs = getTestRuns();
+
+    std::vector<std::unique_ptr<Submission>> submissions;
+    for(std::string const & name : listDirectory(root, true)) {
+        submissions.emplace_back(new Submission(*this, name, root + "/" + name));
+    }
+
+    ThreadPool pool(num_jobs);
+
+    // Every submission is assembled before any tests run.  Each submission's Tester has its own object files, symbol
+    // table, and templates, and otherwise starts as a copy of this one, with the tests already registered.
+    std::vector<ThreadPool::Task> tasks;
+    for(std::unique_ptr<Submission> & submission : submissions) {
+        Submission * sub = submission.get();
+        tasks.push_back([sub, &filenames, asm_print_level]() {
+            std::vector<std::string> submission_filenames = filenames;
+            if(submission_filenames.empty()) {
+                for(std::string const & name : listDirectory(sub->path, false)) {
+                    if(endsWith(name, ".asm") || endsWith(name, ".bin")) {
+                        submission_filenames.push_back(name);
+                    }
+                }
+            }
+            for(std::string & filename : submission_filenames) {
+                filename = sub->path + "/" + filename;
+            }
+
+            Tester & tester = sub->tester;
+            tester.obj_filenames.clear();
+            tester.symbol_table.clear();
+            tester.templates = std::make_shared<TemplateCache>();
+            sub->valid = ! submission_filenames.empty() && assembleFiles(submission_filenames, sub->asm_printer,
+                asm_print_level, tester.obj_filenames, tester.symbol_table);
+        });
+    }
+    pool.run(tasks);
+
+    // Then the runs for every submission share the pool, so that the threads stay busy until the last one is done.
+    tasks.clear();
+    for(std::unique_ptr<Submission> & submission : submissions) {
+        Submission * sub = submission.get();
+        if(! sub->valid) {
+            continue;
+        }
+
+        sub->run_outputs.resize(runs.size());
+        sub->points.resize(runs.size());
+        for(std::size_t i = 0; i < runs.size(); i += 1) {
+            tasks.push_back([sub, i, &runs]() {
+                std::ostringstream run_out;
+                sub->points[i] = sub->tester.testRun(runs[i], run_out);
+                sub->run_outputs[i] = run_out.str();
+            });
+        }
+    }
+    pool.run(tasks);
+
+    std::ofstream summary(root + "/summary.json");
+    summary << "{\n";
+    summary << "    \"submissions\": [\n";
+    for(std::size_t i = 0; i < submissions.size(); i += 1) {
+        Submission const & sub = *submissions[i];
+
+        std::vector<char> const & asm_output = sub.asm_printer.getBuffer();
+        if(! asm_output.empty()) {
+            std::ofstream asm_file(sub.path + "/assembly.txt");
+            asm_file << std::string(asm_output.begin(), asm_output.end());
+        }
+
+        std::ofstream report(sub.path + "/report.json");
+        printReportHeader(report);
+        for(std::string const & run_output : sub.run_outputs) {
+            report << run_output;
+        }
+        std::pair<double, double> total_points = sumPoints(sub.points);
+        printReportFooter(report, std::get<0>(total_points));
+
+        summary << "        {\"name\": \"" << escapeJSON(sub.name) << "\", \"assembled\": "
+                << (sub.valid ? "true" : "false") << ", \"score\": " << std::get<0>(total_points) << "}"
+                << (i + 1 < submissions.size() ? "," : "") << "\n";
+    }
+    summary << "    ]\n";
+    summary << "}\n";
+
+    std::cout << "Graded " << submissions.size() << " submissions in " << root << "\n";
+}
+
+void Tester::printReportHeader(std::ostream & report)
+{
+    report << "{\n";
+
+    report << "    \"tests\": [\n";
+}
+
+void Tester::printReportFooter(std::ostream & report, double score)
+{
+    report << "    ]\n";
+
+    report << "    \"leaderboard\": [],\n";
+    report << "    \"visibility\": \"visible\",\n";
+    report << "    \"execution_time\": 0,\n";
+    report << "    \"score\": " << score << "\n";
+
+    report << "}\n";
+}
+
+std::pair<double, double> Tester::sumPoints(std::vector<std::pair<double, double>> const & points)
+{
+    double total_points_earned = 0, total_points = 0;
+    for(std::pair<double, double> const & run_points : points) {
+        total_points_earned += std::get<0>(run_points);
+        total_points += std::get<1>(run_points);
+    }
     return std::make_pair(total_points_earned, total_points);
 }
 
+std::pair<double, double> Tester::testRun(TestRun const & run, std::ostream & run_out) const
+{
+    // Each run gets its own copy of the Tester, so that the per-test state (the active simulator, points earned, and
+    // output stream) is never shared between threads.
+    Tester run_tester(*this);
+    run_tester.seed = run.seed;
+    run_tester.out = &run_out;
+    return run_tester.testSingle(*run.test, run.points);
+}
+
 std::pair<double, double> Tester::testSingle(std::string const & test_name)
 {
     for(TestCase const & test : tests) {
         if(test.name == test_name) {
-            return testSingle(test);
+            return testSingle(test, test.points);
         }
     }
 
     return std::make_pair(0, 0);
 }
 
-std::pair<double, double> Tester::testSingle(TestCase const & test)
+std::pair<double, double> Tester::testSingle(TestCase const & test, double points)
 {
     resetTestPoints();
 
-    BufferedPrinter printer(print_output);
+    BufferedPrinter printer(print_output, *out);
     StringInputter inputter;
     lc3::sim simulator(printer, inputter, print_level);
+    simulator.setEngineType(engine_type);
     this->printer = &printer;
     this->inputter = &inputter;
     this->simulator = &simulator;
 
-    std::cout << "        {\n";
-    std::cout << "            \"name\": \"" << test.name << "\",\n";
+    *out << "        {\n";
+    *out << "            \"name\": \"" << test.name << "\",\n";
 
-    if(test.randomize) {
-        if(seed == 0) {
-            seed = simulator.randomizeState();
-        } else {
-            simulator.randomizeState(seed);
-        }
-        std::cout << "           \"extra_data\": \"Randomized Machine, Seed: " << seed << "\",\n";
-    }
-
-    for(std::string const & obj_filename : obj_filenames) {
-        if(! simulator.loadObjFile(obj_filename)) {
-            std::cout << "Could not init simulator\n";
-            return std::make_pair(0, test.points);
-        }
+    if(! initSimulator(test, simulator, printer)) {
+        *out << "Could not init simulator\n";
+        return std::make_pair(0, points);
     }
 
     testBringup(simulator);
@@ -220,27 +480,74 @@ std::pair<double, double> Tester::testSingle(TestCase const & test)
     }
 
     try {
-        test.test_func(simulator, *this, test.points);
+        test.test_func(simulator, *this, points);
     } catch(lc3::utils::exception const & e) {
         error("c++ exception", std::string(e.what()));
-        std::cout << "Test case ran into exception: " << e.what() << "\n";
-        return std::make_pair(0, test.points);
+        *out << "Test case ran into exception: " << e.what() << "\n";
+        return std::make_pair(0, points);
     }
 
     testTeardown(simulator);
 
     // In case the verify points don't add up to the total points, clamp
-    double points_earned = std::min(test_points_earned, test.points);
-    std::cout << "            \"score\": " << points_earned << ",\n"
-              << "            \"max_score\": " << test.points << "\n";
+    double points_earned = std::min(test_points_earned, points);
+    *out << "            \"score\": " << points_earned << ",\n"
+              << "            \"max_score\": " << points << "\n";
 
-    std::cout << "        },\n";
+    *out << "        },\n";
 
     this->printer = nullptr;
     this->inputter = nullptr;
     this->simulator = nullptr;
 
-    return std::make_pair(points_earned, test.points);
+    return std::make_pair(points_earned, points);
+}
+
+bool Tester::initSimulator(TestCase const & test, lc3::sim & simulator, BufferedPrinter & printer)
+{
+    // Until a random seed has been picked, there is no template for a randomized machine.
+    bool has_template = ! test.randomize || seed != 0;
+    std::pair<bool, uint64_t> key = std::make_pair(test.randomize, test.randomize ? seed : 0);
+    bool found = false;
+    TestTemplate tmpl;
+    if(has_template) {
+        std::lock_guard<std::mutex> lock(templates->mutex);
+        auto search = templates->templates.find(key);
+        if(search != templates->templates.end()) {
+            tmpl = search->second;
+            found = true;
+        }
+    }
+
+    if(test.randomize) {
+        if(seed == 0) {
+            seed = simulator.randomizeState();
+        } else if(! found) {
+            simulator.randomizeState(seed);
+        }
+        *out << "           \"extra_data\": \"Randomized Machine, Seed: " << seed << "\",\n";
+    }
+
+    if(found) {
+        simulator.restore(tmpl.snapshot);
+        if(! tmpl.load_output.empty()) {
+            printer.print(tmpl.load_output);
+        }
+        return true;
+    }
+
+    for(std::string const & obj_filename : obj_filenames) {
+        if(! simulator.loadObjFile(obj_filename)) {
+            return false;
+        }
+    }
+
+    // If another thread built the same template in the meantime, either one will do.
+    std::vector<char> const & load_output = printer.getBuffer();
+    TestTemplate built{simulator.snapshot(), std::string(load_output.begin(), load_output.end())};
+    std::lock_guard<std::mutex> lock(templates->mutex);
+    templates->templates[std::make_pair(test.randomize, test.randomize ? seed : 0)] = built;
+    return true;
 }
 
 void Tester::verify(std::string const & label, bool pred, double points)
@@ -248,20 +555,20 @@ void Tester::verify(std::string const & label, bool pred, double points)
     if(pred) {
         test_points_earned += points;
     }  else {
-        std::cout << "            \"output\": \"" << label << "\",\n";
+        *out << "            \"output\": \"" << label << "\",\n";
      }
 }
 
 void Tester::output(std::string const & message)
 {
     if(verbose) {
-        std::cout << "  " << message << "\n";
+        *out << "  " << message << "\n";
     }
 }
 
 void Tester::error(std::string const & label, std::string const & message)
 {
-    std::cout << "  " << label << " => " << message << " (+0 pts)\n";
+    *out << "  " << label << " => " << message << " (+0 pts)\n";
 }
 
 void Tester::resetTestPoints(void)
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <vector>
@@ -39,21 +41,60 @@ private:
     bool print_output, ignore_privilege, verbose;
     uint32_t print_level;
     uint64_t seed;
+    uint32_t num_jobs, num_seeds;
+    lc3::core::EngineType engine_type;
     std::vector<std::string> obj_filenames;
     lc3::core::SymbolTable symbol_table;
 
+    // Test output, including the program output if it is printed.  When tests run in parallel, each one runs on its
+    // own copy of the Tester and writes to its own stream, which are printed in registration order afterwards.
+    std::ostream * out;
+
     BufferedPrinter * printer;
     StringInputter * inputter;
     lc3::sim * simulator;
 
+    // The machine as it is right after randomizing (if requested) and loading the object files, along with anything
+    // printed while doing so.  Templates are keyed by whether the machine was randomized and with which seed, and
+    // each test starts by restoring one into a fresh simulator rather than reloading the object files.  The cache is
+    // shared by every copy of the Tester.
+    struct TestTemplate
+    {
+        lc3::core::PSnapshot snapshot;
+        std::string load_output;
+    };
+    struct TemplateCache
+    {
+        std::mutex mutex;
+        std::map<std::pair<bool, uint64_t>, TestTemplate> templates;
+    };
+    std::shared_ptr<TemplateCache> templates;
+
+    // A single run of a test case.  With multiple seeds, a randomized test is run once per seed for an equal share of
+    // its points.
+    struct TestRun
+    {
+        TestCase const * test;
+        uint64_t seed;
+        double points;
+    };
+
     double test_points_earned;
 
+    std::vector<TestRun> getTestRuns(void);
     std::pair<double, double> testAll(void);
     std::pair<double, double> testSingle(std::string const & test_name);
+    void testBatch(std::string const & root, std::vector<std::string> const & filenames, uint32_t asm_print_level);
 
-    std::pair<double, double> testSingle(TestCase const & test);
+    std::pair<double, double> testSingle(TestCase const & test, double points);
+    std::pair<double, double> testRun(TestRun const & run, std::ostream & run_out) const;
+    bool initSimulator(TestCase const & test, lc3::sim & simulator, BufferedPrinter & printer);
     void resetTestPoints(void);
 
+    static void printReportHeader(std::ostream & report);
+    static void printReportFooter(std::ostream & report, double score);
+    static std::pair<double, double> sumPoints(std::vector<std::pair<double, double>> const & points);
+
     double checkSimilarityHelper(std::vector<char> const & source, std::vector<char> const & target) const;
 
     friend int main(int argc, char * argv[]);
@@ -88,6 +129,8 @@ public:
 
 private:
     void setSymbolTable(lc3::core::SymbolTable const & symbol_table) { this->symbol_table = symbol_table; }
+    void setConcurrency(uint32_t num_jobs, uint32_t num_seeds);
+    void setEngineType(lc3::core::EngineType engine_type) { this->engine_type = engine_type; }
     friend int framework2::main(int argc, char * argv[]);
 };
 
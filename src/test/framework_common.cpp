@@ -1,6 +1,9 @@
 /*
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
+#include <algorithm>
+#include <limits>
+
 #include "framework_common.h"
 
 bool endsWith(std::string const & search, std::string const & suffix)
@@ -13,7 +16,7 @@ void BufferedPrinter::print(std::string const & string)
 {
     std::copy(string.begin(), string.end(), std::back_inserter(display_buffer));
     if(print_output) {
-        std::cout << string;
+        out << string;
     }
 }
 
@@ -21,7 +24,7 @@ void BufferedPrinter::newline(void)
 {
     display_buffer.push_back('\n');
     if(print_output) {
-        std::cout << "\n";
+        out << "\n";
     }
 }
 
@@ -60,3 +63,17 @@ bool StringInputter::getChar(char & c)
     return true;
 }
 
+uint64_t StringInputter::getIdleCalls(void) const
+{
+    if(pos == source.size()) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    return cur_inst_delay;
+}
+
+void StringInputter::skipIdleCalls(uint64_t count)
+{
+    cur_inst_delay -= static_cast<uint32_t>(std::min<uint64_t>(count, cur_inst_delay));
+}
+
@@ -2,6 +2,7 @@
  * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
  */
 #include <cstdint>
+#include <iostream>
 #include <string>
 
 #include "inputter.h"
@@ -11,7 +12,8 @@
 class BufferedPrinter : public lc3::utils::IPrinter
 {
 public:
-    BufferedPrinter(bool print_output) : print_output(print_output) {}
+    BufferedPrinter(bool print_output) : BufferedPrinter(print_output, std::cout) {}
+    BufferedPrinter(bool print_output, std::ostream & out) : print_output(print_output), out(out) {}
 
     virtual void setColor(lc3::utils::PrintColor color) override { (void) color; }
     virtual void print(std::string const & string) override;
@@ -21,6 +23,7 @@ public:
 
 private:
     bool print_output;
+    std::ostream & out;
     std::vector<char> display_buffer;
 };
 
@@ -37,6 +40,8 @@ public:
     virtual bool getChar(char & c) override;
     virtual void endInput(void) override {}
     virtual bool hasRemaining(void) const override { return pos == source.size(); }
+    virtual uint64_t getIdleCalls(void) const override;
+    virtual void skipIdleCalls(uint64_t count) override;
 
 private:
     std::string source;
@@ -4,7 +4,8 @@
 #define API_VER 2
 #include "framework.h"
 
-uint32_t sub_count;
+// Tests may run in parallel (see --jobs), so state shared between a test and its callbacks is kept per thread.
+thread_local uint32_t sub_count;
 
 void verify(Tester & tester, lc3::sim & sim, bool success, uint16_t expected_val, uint64_t expected_sub_count,
     double points)
@@ -0,0 +1,53 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#define API_VER 2
+#include "framework.h"
+
+static constexpr uint64_t InstLimit = 10000;
+
+void verify(bool success, bool exceeded_inst_limit, uint32_t expected, uint32_t actual, std::string const & label,
+    double points, Tester & tester)
+{
+    std::stringstream stream;
+    stream << "Expected: " << expected << "; Actual: " << actual;
+    tester.output(stream.str());
+
+    if(success) {
+        if(! exceeded_inst_limit) {
+            tester.verify(label, actual == expected, points);
+        } else {
+            tester.error(label, "Exceeded instruction limit");
+        }
+    } else {
+        tester.error(label, "Execution failed");
+    }
+}
+
+void PatchTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    bool success = sim.runUntilHalt();
+    bool exceeded_inst_limit = sim.didExceedInstLimit();
+    verify(success, exceeded_inst_limit, 100 * 1 + 2, sim.readMem(0x3100), "Patch subroutine", total_points / 2,
+        tester);
+    verify(success, exceeded_inst_limit, 100 * 1 + 100 * 2, sim.readMem(0x3101), "Patch running block",
+        total_points / 2, tester);
+}
+
+void testBringup(lc3::sim & sim)
+{
+    sim.writePC(0x3000);
+    sim.setRunInstLimit(InstLimit);
+}
+
+void testTeardown(lc3::sim & sim)
+{
+    (void) sim;
+}
+
+void setup(Tester & tester)
+{
+    tester.registerTest("Patch", PatchTest, 100, false);
+}
+
+void shutdown(void) {}
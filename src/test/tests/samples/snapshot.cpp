@@ -0,0 +1,178 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <vector>
+#include <string>
+
+#define API_VER 2
+#include "framework.h"
+
+static constexpr uint64_t InstLimit = 20000;
+// Enough instructions to be partway through the loop, with both keys buffered by the keyboard.
+static constexpr uint64_t SnapshotInsts = 300;
+static constexpr uint16_t LoopAddr = 0x3002;
+static constexpr uint16_t Sum = 200 * 201 / 2;
+
+// Everything a program can observe about the machine.
+struct MachineImage
+{
+    std::vector<uint16_t> regs;
+    uint16_t pc, psr, mcr, kbsr, kbdr, dsr;
+    std::vector<uint16_t> mem;
+    std::vector<std::string> lines;
+};
+
+MachineImage capture(lc3::sim & sim)
+{
+    MachineImage image;
+    for(uint16_t reg = 0; reg < 8; reg += 1) {
+        image.regs.push_back(sim.readReg(reg));
+    }
+    image.pc = sim.readPC();
+    image.psr = sim.readPSR();
+    image.mcr = sim.readMCR();
+    image.kbsr = sim.readMem(0xFE00);
+    image.kbdr = sim.readMem(0xFE02);
+    image.dsr = sim.readMem(0xFE04);
+    for(uint32_t addr = 0; addr < 0xFE00; addr += 1) {
+        image.mem.push_back(sim.readMem(static_cast<uint16_t>(addr)));
+        image.lines.push_back(sim.getMemLine(static_cast<uint16_t>(addr)));
+    }
+    return image;
+}
+
+void compareField(Tester & tester, std::string const & name, uint16_t expected, uint16_t actual, bool & match)
+{
+    if(expected != actual) {
+        std::stringstream stream;
+        stream << name << ": Expected: " << expected << "; Actual: " << actual;
+        tester.output(stream.str());
+        match = false;
+    }
+}
+
+bool compareImages(Tester & tester, MachineImage const & expected, MachineImage const & actual)
+{
+    bool match = true;
+    for(uint16_t reg = 0; reg < 8; reg += 1) {
+        compareField(tester, "R" + std::to_string(reg), expected.regs[reg], actual.regs[reg], match);
+    }
+    compareField(tester, "PC", expected.pc, actual.pc, match);
+    compareField(tester, "PSR", expected.psr, actual.psr, match);
+    compareField(tester, "MCR", expected.mcr, actual.mcr, match);
+    compareField(tester, "KBSR", expected.kbsr, actual.kbsr, match);
+    compareField(tester, "KBDR", expected.kbdr, actual.kbdr, match);
+    compareField(tester, "DSR", expected.dsr, actual.dsr, match);
+
+    // Only the first few differences in memory are reported.
+    uint32_t mem_mismatches = 0;
+    for(uint32_t addr = 0; addr < expected.mem.size(); addr += 1) {
+        if(expected.mem[addr] != actual.mem[addr] || expected.lines[addr] != actual.lines[addr]) {
+            if(mem_mismatches < 4) {
+                std::stringstream stream;
+                stream << "mem[" << addr << "]: Expected: " << expected.mem[addr] << " '" << expected.lines[addr]
+                       << "'; Actual: " << actual.mem[addr] << " '" << actual.lines[addr] << "'";
+                tester.output(stream.str());
+            }
+            mem_mismatches += 1;
+            match = false;
+        }
+    }
+    return match;
+}
+
+// Changes every part of the machine that a snapshot covers.  The loop is patched and then run, so the block that holds
+// it is cached with code that the restore has to discard.
+void mutate(lc3::sim & sim)
+{
+    sim.writeMem(LoopAddr, 0x1260);     // ADD R1, R1, #0
+    sim.setRunInstLimit(InstLimit);
+    sim.runUntilHalt();
+
+    for(uint16_t reg = 0; reg < 8; reg += 1) {
+        sim.writeReg(reg, 0xDEAD + reg);
+    }
+    sim.writePC(0x4000);
+    sim.writePSR(0x0004);
+    sim.writeMem(0xFE00, 0x4000);
+    sim.writeMem(0x4000, 0x1234);
+    sim.writeMem(0x3100, 0x5678);
+    sim.setMemLine(0x3000, "mutated");
+}
+
+void verifyResume(lc3::sim & sim, Tester & tester, double points)
+{
+    sim.setRunInstLimit(InstLimit);
+    bool success = sim.runUntilHalt();
+    if(! success || sim.didExceedInstLimit()) {
+        tester.error("Resumed program", "Did not reach HALT");
+        return;
+    }
+
+    std::stringstream stream;
+    stream << "Expected: " << Sum << " 'x' 'y'; Actual: " << sim.readMem(0x3100) << " '"
+           << static_cast<char>(sim.readMem(0x3101)) << "' '" << static_cast<char>(sim.readMem(0x3102)) << "'";
+    tester.output(stream.str());
+    tester.verify("Resumed program", sim.readMem(0x3100) == Sum && sim.readMem(0x3101) == 'x' &&
+        sim.readMem(0x3102) == 'y', points);
+}
+
+lc3::core::PSnapshot runToSnapshot(lc3::sim & sim, Tester & tester, MachineImage & image)
+{
+    tester.setInputString("xy");
+    sim.setRunInstLimit(SnapshotInsts);
+    sim.run();
+    image = capture(sim);
+    return sim.snapshot();
+}
+
+void RestoreTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    MachineImage expected;
+    lc3::core::PSnapshot snapshot = runToSnapshot(sim, tester, expected);
+
+    // The second round starts from a restored machine, whose pages are shared with the snapshot.
+    for(uint32_t round = 1; round <= 2; round += 1) {
+        mutate(sim);
+        sim.restore(snapshot);
+        tester.verify("Restore " + std::to_string(round), compareImages(tester, expected, capture(sim)),
+            total_points / 3);
+    }
+
+    verifyResume(sim, tester, total_points / 3);
+}
+
+void OtherMachineTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    MachineImage expected;
+    lc3::core::PSnapshot snapshot = runToSnapshot(sim, tester, expected);
+    mutate(sim);
+
+    lc3::utils::NullPrinter printer;
+    lc3::utils::NullInputter inputter;
+    lc3::sim other(printer, inputter, 0);
+    other.restore(snapshot);
+    tester.verify("Restore", compareImages(tester, expected, capture(other)), total_points / 2);
+
+    verifyResume(other, tester, total_points / 2);
+}
+
+void testBringup(lc3::sim & sim)
+{
+    sim.writePC(0x3000);
+    sim.setRunInstLimit(InstLimit);
+}
+
+void testTeardown(lc3::sim & sim)
+{
+    (void) sim;
+}
+
+void setup(Tester & tester)
+{
+    tester.registerTest("Restore", RestoreTest, 40, false);
+    tester.registerTest("Restore", RestoreTest, 30, true);
+    tester.registerTest("Other Machine", OtherMachineTest, 30, false);
+}
+
+void shutdown(void) {}
@@ -0,0 +1,44 @@
+; Stores new instructions into code that has already run.  Each part runs its code often enough for the simulator to
+; cache it (and, with the JIT engine, compile it) before the store, so a stale copy would give a different result.
+        .ORIG x3000
+
+; Part 1: patch a hot subroutine between calls.  The result is 100 * 1 + 2.
+        AND R2, R2, #0
+        LD  R3, COUNT1
+LOOP1   JSR BODY
+        ADD R3, R3, #-1
+        BRp LOOP1
+        LD  R0, INC2
+        ST  R0, PATCH
+        JSR BODY
+        STI R2, RESULT1
+
+; Part 2: patch the next instruction of the block that is running, alternating between two instructions.  The result
+; is 100 * 1 + 100 * 2.
+        AND R4, R4, #0
+        AND R5, R5, #0
+        LD  R3, COUNT2
+LOOP2   NOT R5, R5
+        BRz EVEN
+        LD  R0, INC4_1
+        BRnzp STORE
+EVEN    LD  R0, INC4_2
+STORE   ST  R0, SLOT
+SLOT    ADD R4, R4, #0
+        ADD R3, R3, #-1
+        BRp LOOP2
+        STI R4, RESULT2
+        HALT
+
+BODY
+PATCH   ADD R2, R2, #1
+        RET
+
+INC2    ADD R2, R2, #2
+INC4_1  ADD R4, R4, #1
+INC4_2  ADD R4, R4, #2
+COUNT1  .FILL #100
+COUNT2  .FILL #200
+RESULT1 .FILL x3100
+RESULT2 .FILL x3101
+        .END
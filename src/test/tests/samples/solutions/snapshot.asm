@@ -0,0 +1,20 @@
+; Sums 200 down to 1, then reads two keys.  The snapshot tester stops it partway through the loop, so its state
+; includes a hot block and keys that have been buffered by the keyboard but not yet read.
+        .ORIG x3000
+        AND R1, R1, #0
+        LD  R2, COUNT
+LOOP    ADD R1, R1, R2
+        ADD R2, R2, #-1
+        BRp LOOP
+        STI R1, RESULT
+        GETC
+        STI R0, KEY1
+        GETC
+        STI R0, KEY2
+        HALT
+
+COUNT   .FILL #200
+RESULT  .FILL x3100
+KEY1    .FILL x3101
+KEY2    .FILL x3102
+        .END
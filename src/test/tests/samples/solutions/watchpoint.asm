@@ -0,0 +1,24 @@
+; Makes a known sequence of loads and stores for the watchpoint tester.
+        .ORIG x3000
+        LD  R1, DATA
+        LDR R0, R1, #0      ; x3001: read VAL
+        ADD R0, R0, #1
+        STR R0, R1, #0      ; x3003: VAL changes from 41 to 42
+        STR R0, R1, #0      ; x3004: VAL is stored again, unchanged
+        STR R0, R1, #1      ; x3005-x3008: fill ARRAY
+        STR R0, R1, #2
+        STR R0, R1, #3
+        STR R0, R1, #4
+        LDI R2, KBSR        ; x3009: read the keyboard status register
+        AND R3, R3, #0
+        STI R3, KBSR        ; x300B: write it
+        HALT
+
+DATA    .FILL x3100
+KBSR    .FILL xFE00
+        .END
+
+        .ORIG x3100
+VAL     .FILL #41
+ARRAY   .BLKW #4
+        .END
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#include <vector>
+#include <string>
+
+#define API_VER 2
+#include "framework.h"
+
+static constexpr uint64_t InstLimit = 1000;
+static constexpr uint16_t Val = 0x3100;
+static constexpr uint16_t Array = 0x3101;
+
+using lc3::core::WatchpointType;
+
+// A watchpoint hit along with the PC when the callback was triggered.
+struct Hit
+{
+    uint16_t pc, addr, old_value, new_value;
+    WatchpointType type;
+};
+
+std::vector<Hit> hits;
+
+std::ostream & operator<<(std::ostream & out, std::vector<Hit> const & list)
+{
+    out << "[";
+    for(Hit const & hit : list) {
+        out << " " << lc3::core::watchpointTypeToString(hit.type) << "@x" << std::hex << hit.addr << " (" << std::dec
+            << hit.old_value << " -> " << hit.new_value << ", pc x" << std::hex << hit.pc << std::dec << ")";
+    }
+    out << " ]";
+    return out;
+}
+
+void watchpointCallback(lc3::core::CallbackType type, lc3::sim & sim)
+{
+    (void) type;
+    for(lc3::core::WatchpointHit const & hit : sim.getWatchpointHits()) {
+        hits.push_back(Hit{sim.readPC(), hit.addr, hit.old_value, hit.new_value, hit.type});
+    }
+}
+
+// Runs the program to its HALT and checks that exactly the expected hits were reported, in order.
+void verifyHits(lc3::sim & sim, Tester & tester, std::vector<Hit> const & expected, std::string const & label,
+    double points)
+{
+    bool success = sim.runUntilHalt();
+    if(! success || sim.didExceedInstLimit()) {
+        tester.error(label, "Did not reach HALT");
+        return;
+    }
+
+    bool match = hits.size() == expected.size();
+    for(size_t i = 0; match && i < hits.size(); i += 1) {
+        match = hits[i].pc == expected[i].pc && hits[i].addr == expected[i].addr &&
+            hits[i].old_value == expected[i].old_value && hits[i].new_value == expected[i].new_value &&
+            hits[i].type == expected[i].type;
+    }
+
+    std::stringstream stream;
+    stream << "Expected: " << expected << "; Actual: " << hits;
+    tester.output(stream.str());
+    tester.verify(label, match, points);
+}
+
+void ReadTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    sim.setWatchpoint(Val, Val, WatchpointType::READ);
+    verifyHits(sim, tester, {{0x3002, Val, 41, 41, WatchpointType::READ}}, "Read", total_points);
+}
+
+void WriteTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    sim.setWatchpoint(Val, Val, WatchpointType::WRITE);
+    verifyHits(sim, tester, {
+        {0x3004, Val, 41, 42, WatchpointType::WRITE},
+        {0x3005, Val, 42, 42, WatchpointType::WRITE}
+    }, "Write", total_points);
+}
+
+void ChangeTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    // The second store leaves the value unchanged, so only the first is reported.
+    sim.setWatchpoint(Val, Val, WatchpointType::CHANGE);
+    verifyHits(sim, tester, {{0x3004, Val, 41, 42, WatchpointType::CHANGE}}, "Change", total_points);
+}
+
+void RangeTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    // The program fills four words, but only the first three are watched.
+    sim.setWatchpoint(Array, Array + 2, WatchpointType::WRITE);
+    verifyHits(sim, tester, {
+        {0x3006, Array, 0, 42, WatchpointType::WRITE},
+        {0x3007, Array + 1, 0, 42, WatchpointType::WRITE},
+        {0x3008, Array + 2, 0, 42, WatchpointType::WRITE}
+    }, "Range", total_points);
+}
+
+void MMIOTest(lc3::sim & sim, Tester & tester, double total_points)
+{
+    sim.setWatchpoint(KBSR, KBSR, WatchpointType::READ);
+    sim.setWatchpoint(KBSR, KBSR, WatchpointType::WRITE);
+    verifyHits(sim, tester, {
+        {0x300A, KBSR, 0, 0, WatchpointType::READ},
+        {0x300C, KBSR, 0, 0, WatchpointType::WRITE}
+    }, "Keyboard status register", total_points);
+}
+
+void testBringup(lc3::sim & sim)
+{
+    // Device registers can only be accessed in supervisor mode.
+    sim.writePC(0x3000);
+    sim.writePSR(0x0002);
+    sim.setRunInstLimit(InstLimit);
+    hits.clear();
+    sim.registerCallback(lc3::core::CallbackType::WATCHPOINT, watchpointCallback);
+}
+
+void testTeardown(lc3::sim & sim)
+{
+    sim.registerCallback(lc3::core::CallbackType::WATCHPOINT, nullptr);
+    sim.clearWatchpoints();
+}
+
+void setup(Tester & tester)
+{
+    tester.registerTest("Read", ReadTest, 20, false);
+    tester.registerTest("Write", WriteTest, 20, false);
+    tester.registerTest("Change", ChangeTest, 20, false);
+    tester.registerTest("Range", RangeTest, 20, false);
+    tester.registerTest("MMIO", MMIOTest, 20, false);
+}
+
+void shutdown(void) {}
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2020 McGraw-Hill Education. All rights reserved. No reproduction or distribution without the prior written consent of McGraw-Hill Education.
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a fixed set of tasks on a pool of threads.  Tasks are dealt out round-robin to a deque per thread before any of
+// them start.  Each thread takes work from the front of its own deque and, once that is empty, steals from the back of
+// the others', so that a few long tasks do not leave the rest of the threads idle.  The calling thread acts as one of
+// the workers.
+class ThreadPool
+{
+public:
+    using Task = std::function<void(void)>;
+
+    explicit ThreadPool(uint32_t num_threads) : queues(num_threads == 0 ? 1 : num_threads) {}
+
+    void run(std::vector<Task> const & tasks)
+    {
+        for(std::size_t i = 0; i < tasks.size(); i += 1) {
+            queues[i % queues.size()].tasks.push_back(&tasks[i]);
+        }
+
+        std::vector<std::thread> threads;
+        for(uint32_t id = 1; id < queues.size(); id += 1) {
+            threads.emplace_back(&ThreadPool::work, this, id);
+        }
+        work(0);
+        for(std::thread & thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task const *> tasks;
+    };
+
+    std::vector<Queue> queues;
+
+    void work(uint32_t id)
+    {
+        for(Task const * task = take(id); task != nullptr; task = take(id)) {
+            (*task)();
+        }
+    }
+
+    // No tasks are added once the pool is running, so every queue being empty means there is no work left.
+    Task const * take(uint32_t id)
+    {
+        {
+            Queue & own = queues[id];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if(! own.tasks.empty()) {
+                Task const * task = own.tasks.front();
+                own.tasks.pop_front();
+                return task;
+            }
+        }
+
+        for(std::size_t offset = 1; offset < queues.size(); offset += 1) {
+            Queue & victim = queues[(id + offset) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if(! victim.tasks.empty()) {
+                Task const * task = victim.tasks.back();
+                victim.tasks.pop_back();
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+};
+
+#endif